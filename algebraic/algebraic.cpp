@@ -6,16 +6,26 @@
 #include "complex.hpp"
 #include "polynomial.hpp"
 #include "collatz.hpp"
-//#include "polyval.hpp"
+#include "polyval.hpp"
+#include "numberfield.hpp"
+#include "serialize.hpp"
+#include "mappedfile.hpp"
+#include "residual.hpp"
+#include "matrix.hpp"
+#include "complexroots.hpp"
 
 #include <map>
 #include <thread>
 #include <set>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <random>
 
 using I = BigInt<>;
 using R = Rational<I>;
 using P = Polynomial<R>;
-//using V = PolyVal<P>;
+using V = PolyVal<P>;
 using Z = Complex<R>;
 
 std::string RoundedString(R Val, int RoundToDecimal) {
@@ -108,8 +118,776 @@ void run() {
     std::cout << "\n\n";
 }
 
-int main() {
+// Isolates the real roots of the test polynomials with the serial and the pooled EvaluateRootsInRange, the two have
+// to agree root for root since both refine the same leaf intervals
+void CheckRoots() {
+    std::vector<std::pair<std::string, P>> Polys {
+        { "(x^2 - 2)^2", P::Pow(P(1, 2) - P(2, 0), 2) },
+        { "x^5 - x - 1", P(1, 5) - P(1, 1) - P(1, 0) },
+        { "x^24 - x - 1", P(1, 24) - P(1, 1) - P(1, 0) },
+    };
+    for (unsigned int n : { 4, 8, 12, 16 }) Polys.push_back({ "H(" + std::to_string(n) + ")", GenerateH(n) });
+    P Close(1, 0);
+    for (int64_t k = 1; k <= 12; ++k) Close *= P(1, 1) - P(R(I(k), I(1000)), 0);
+    Polys.push_back({ "(x - 1/1000)...(x - 12/1000)", Close });
+
+    WorkPool Pool(4);
+    size_t Mismatches = 0;
+    for (const auto& [Name, Poly] : Polys) {
+        const auto Sturm = P::MakeSturmSequence(Poly);
+        const R Bound = P::CauchyBounds(Poly);
+        const R MaxError = R::Pow(10, -10);
+
+        const auto Start = std::chrono::steady_clock::now();
+        const std::vector<R> Serial = P::EvaluateRootsInRange(Sturm, -Bound, Bound, MaxError);
+        const auto Mid = std::chrono::steady_clock::now();
+        const std::vector<R> Pooled = P::EvaluateRootsInRange(Sturm, -Bound, Bound, MaxError, Pool);
+        const auto End = std::chrono::steady_clock::now();
+
+        const bool Same = Serial.size() == Pooled.size() && std::equal(Serial.begin(), Serial.end(), Pooled.begin(), [](const R& A, const R& B) {
+            return (A - B).IsZero();
+        });
+        Mismatches += !Same;
+        std::cout << Name << ": " << Serial.size() << " roots, serial " << std::chrono::duration<double, std::milli>(Mid - Start).count()
+            << "ms, pool " << std::chrono::duration<double, std::milli>(End - Mid).count() << "ms" << (Same ? "" : ", MISMATCH") << "\n";
+    }
+    std::cout << "Checked pooled root isolation against serial, " << Mismatches << " mismatches\n";
+}
+
+// Minimal polynomial of b = a^2 + a - 2/3 for a root a of the Selmer polynomial x^n - x - 1, both routes
+void BenchMinimalPolynomial() {
+    for (uint32_t n : { 4, 8, 16, 24, 32 }) {
+        NumberField<R> Field(P(1, n) - P(1, 1) - P(1, 0));
+        const P Beta = P(1, 2) + P(1, 1) - P(R(2, 3), 0);
+
+        auto Start = std::chrono::steady_clock::now();
+        const P ByLinearAlgebra = Field.MinimalPolynomial(Beta);
+        auto Mid = std::chrono::steady_clock::now();
+        const P ByResultant = Field.MinimalPolynomialByResultant(Beta);
+        auto End = std::chrono::steady_clock::now();
+
+        std::cout << "n = " << n
+            << ": linear algebra " << std::chrono::duration<double, std::milli>(Mid - Start).count() << "ms"
+            << ", resultant " << std::chrono::duration<double, std::milli>(End - Mid).count() << "ms"
+            << ((ByLinearAlgebra - ByResultant).IsZero() ? "" : ", MISMATCH") << "\n";
+    }
+}
+
+// TaylorShift up to degree 256 against Horner over polynomials, Res = Res (x + a) + c_i, and Composite with x + a
+// Fractions always shift by Horner over the integers, residues split above TaylorShiftThreshold coefficients
+void BenchTaylorShift() {
+    std::mt19937_64 Rng(1);
+    auto Time = [](auto&& Fn) {
+        const auto Start = std::chrono::steady_clock::now();
+        auto Res = Fn();
+        return std::make_pair(std::move(Res), std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start).count());
+    };
+
+    for (uint32_t Degree : { 64, 256 }) {
+        P Poly;
+        for (uint32_t Exp = 0; Exp <= Degree; ++Exp) Poly += P(R(int64_t(Rng() % 2001) - 1000), Exp);
+
+        for (const R& Shift : { R(3), R(I(3), I(7)) }) {
+            const auto [Shifted, ShiftTime] = Time([&] { return P::TaylorShift(Poly, Shift); });
+            const auto [Composed, CompositeTime] = Time([&] { return P::Composite(Poly, P(1, 1) + P(Shift, 0)); });
+            const auto [Ref, RefTime] = Time([&] {
+                P Res;
+                for (uint32_t Exp = Degree + 1; Exp-- > 0;) Res = Res * (P(1, 1) + P(Shift, 0)) + P(Poly.GetCof(Exp), 0);
+                return Res;
+            });
+
+            const std::string ShiftString = I::ToString(Shift.Numerator()) + (Shift.Denominator() == I(1) ? "" : "/" + I::ToString(Shift.Denominator()));
+            std::cout << "Degree " << Degree << " by " << ShiftString << ": TaylorShift " << ShiftTime << "ms, Composite "
+                << CompositeTime << "ms, Horner over polynomials " << RefTime << "ms"
+                << ((Shifted - Ref).IsZero() && (Composed - Ref).IsZero() ? "" : ", MISMATCH") << "\n";
+        }
+    }
+
+    // Residues cost the same at any size, so above TaylorShiftThreshold coefficients they split
+    using PM = Polynomial<ModInt>;
+    const uint64_t Prime = ModInt::LargePrimes(1)[0];
+    for (uint32_t Degree : { 127, 256, 1024 }) {
+        PM Poly;
+        for (uint32_t Exp = 0; Exp <= Degree; ++Exp) Poly += PM(ModInt(int64_t(Rng() % Prime), Prime), Exp);
+
+        const ModInt Shift(3, Prime);
+        const auto [Shifted, ShiftTime] = Time([&] { return PM::TaylorShift(Poly, Shift); });
+        const auto [Ref, RefTime] = Time([&] {
+            PM Res;
+            for (uint32_t Exp = Degree + 1; Exp-- > 0;) Res = Res * (PM(ModInt(1, Prime), 1) + PM(Shift, 0)) + PM(Poly.GetCof(Exp), 0);
+            return Res;
+        });
+
+        std::cout << "Degree " << Degree << " mod " << Prime << " by 3: TaylorShift " << ShiftTime << "ms, Horner over polynomials "
+            << RefTime << "ms" << ((Shifted - Ref).IsZero() ? "" : ", MISMATCH") << "\n";
+    }
+}
+
+// Checks Matrix against itself and Polynomial: Bareiss against modular determinants with and without a pool,
+// det(A A) = det(A)^2, Sylvester determinants against resultants, and rank and nullspace of singular products
+void CheckMatrix() {
+    using MI = Matrix<I>;
+    using MR = Matrix<R>;
+    using MM = Matrix<ModInt>;
+    std::mt19937_64 Rng(1);
+    auto RandomInteger = [&](int64_t Bound) { return I(int64_t(Rng() % uint64_t(2 * Bound + 1)) - Bound); };
+
+    WorkPool Pool(4);
+    size_t Mismatches = 0;
+    for (size_t N : { 1, 2, 5, 17, 33, 64, 80 }) {
+        MI A(N, N);
+        for (size_t Row = 0; Row < N; ++Row) {
+            for (size_t Col = 0; Col < N; ++Col) A(Row, Col) = RandomInteger(1000);
+        }
+        // The same rows twice makes it singular
+        MI Twice = A;
+        if (N > 1) {
+            for (size_t Col = 0; Col < N; ++Col) Twice(N - 1, Col) = A(0, Col);
+        }
+
+        auto Start = std::chrono::steady_clock::now();
+        const I Bareiss = MI::Determinant(A);
+        auto Mid = std::chrono::steady_clock::now();
+        const I Modular = MI::DeterminantModular(A);
+        auto End = std::chrono::steady_clock::now();
+        std::cout << "n = " << N << ": Bareiss " << std::chrono::duration<double, std::milli>(Mid - Start).count() << "ms"
+            << ", modular " << std::chrono::duration<double, std::milli>(End - Mid).count() << "ms\n";
+
+        Mismatches += Bareiss != Modular || Bareiss != MI::Determinant(A, &Pool) || Bareiss != MI::DeterminantModular(A, &Pool);
+        Mismatches += MI::Determinant(A * A) != Bareiss * Bareiss;
+        if (N > 1) Mismatches += !MI::Determinant(Twice, &Pool).IsZero() || !MI::DeterminantModular(Twice, &Pool).IsZero();
+
+        // Fractions go through row scaling, so the same identity on A / d
+        if (N <= 33) {
+            MR F(N, N);
+            for (size_t Row = 0; Row < N; ++Row) {
+                for (size_t Col = 0; Col < N; ++Col) F(Row, Col) = R(A(Row, Col), I(int64_t(Rng() % 6 + 1)));
+            }
+            const R Det = MR::Determinant(F);
+            Mismatches += !(MR::Determinant(F * F, &Pool) - Det * Det).IsZero();
+        }
+    }
+    std::cout << "Checked determinants, " << Mismatches << " mismatches\n";
+
+    // Random pairs, and pairs built with a shared root so the resultant is 0
+    Mismatches = 0;
+    for (uint32_t i = 0; i < 100; ++i) {
+        P A, B;
+        for (uint32_t Exp = 0; Exp <= 1 + Rng() % 8; ++Exp) A += P(R(RandomInteger(50), I(int64_t(Rng() % 4 + 1))), Exp);
+        for (uint32_t Exp = 0; Exp <= 1 + Rng() % 8; ++Exp) B += P(R(RandomInteger(50), I(int64_t(Rng() % 4 + 1))), Exp);
+        if (i % 4 == 0) {
+            const P Shared = P(1, 1) - P(R(RandomInteger(10), I(int64_t(Rng() % 3 + 1))), 0);
+            A *= Shared;
+            B *= Shared;
+        }
+        if (A.IsZero() || B.IsZero() || A.Degree() == 0 || B.Degree() == 0) continue;
+
+        const R Resultant = P::Resultant(A, B);
+        Mismatches += !(MR::Determinant(MR::Sylvester(A, B)) - Resultant).IsZero();
+        Mismatches += i % 4 == 0 && !Resultant.IsZero();
+    }
+    std::cout << "Checked Sylvester determinants against resultants, " << Mismatches << " mismatches\n";
+
+    // A = L U with L n x r and U r x n has rank r, and every nullspace vector x has A x = 0
+    Mismatches = 0;
+    auto CheckSingular = [&]<typename M>(const M& A, size_t Rank, auto&& IsZero) {
+        const size_t N = A.Cols();
+        const auto Basis = M::Nullspace(A, &Pool);
+        Mismatches += M::Rank(A) != Rank || M::Rank(A, &Pool) != Rank || Basis.size() != N - Rank;
+        if (Basis.empty()) return;
+
+        M Vectors(N, Basis.size());
+        for (size_t i = 0; i < Basis.size(); ++i) {
+            for (size_t Row = 0; Row < N; ++Row) Vectors(Row, i) = Basis[i][Row];
+        }
+        const M Product = A * Vectors;
+        for (size_t Row = 0; Row < Product.Rows(); ++Row) {
+            for (size_t Col = 0; Col < Product.Cols(); ++Col) Mismatches += !IsZero(Product(Row, Col));
+        }
+        // The basis vectors are independent
+        Mismatches += M::Rank(Vectors) != Basis.size();
+    };
+    for (auto [N, Rank] : { std::pair<size_t, size_t> { 4, 0 }, { 4, 2 }, { 9, 5 }, { 20, 11 }, { 70, 40 } }) {
+        MI L(N, Rank), U(Rank, N);
+        MR LF(N, Rank), UF(Rank, N);
+        MM LM(N, Rank), UM(Rank, N);
+        for (size_t Row = 0; Row < N; ++Row) {
+            for (size_t Col = 0; Col < Rank; ++Col) {
+                L(Row, Col) = RandomInteger(20);
+                U(Col, Row) = RandomInteger(20);
+                LF(Row, Col) = R(L(Row, Col), I(int64_t(Rng() % 5 + 1)));
+                UF(Col, Row) = R(U(Col, Row), I(int64_t(Rng() % 5 + 1)));
+                LM(Row, Col) = ModInt(int64_t(Rng() % 1000003), 1000003);
+                UM(Col, Row) = ModInt(int64_t(Rng() % 1000003), 1000003);
+            }
+        }
+        CheckSingular(L * U, Rank, [](const I& Val) { return Val.IsZero(); });
+        CheckSingular(LF * UF, Rank, [](const R& Val) { return Val.IsZero(); });
+        // A zero first column makes it free, so the first basis vector holds nothing but its free entry. The empty
+        // product has no entry that knows the modulus, so it is left out
+        if (Rank > 0) {
+            MM Modular = LM * UM;
+            for (size_t Row = 0; Row < N; ++Row) Modular(Row, 0) = ModInt(0, 1000003);
+            CheckSingular(Modular, Rank, [](const ModInt& Val) { return Val.IsZero(); });
+        }
+    }
+    std::cout << "Checked rank and nullspace of singular matrices, " << Mismatches << " mismatches\n";
+}
+
+// Checks ComplexRoots: box counts across the real axis against Sturm counts, real isolating boxes against Sturm
+// counts over the Cauchy bound, and the roots of x^4 + 1, x^3 - 1 and (x^2 + 1)^2 (x - 3) against their closed forms
+void CheckComplexRoots() {
+    using CR = ComplexRoots<R>;
+    std::mt19937_64 Rng(1);
+    auto RandomInt = [&](int64_t Bound) { return int64_t(Rng() % uint64_t(2 * Bound + 1)) - Bound; };
+
+    // Real roots at halves, the others at least 2 off the axis, so a box [a, b] x [-1, 1] holds exactly the real
+    // roots in [a, b]. Its sides are at thirds and miss every root
+    size_t Mismatches = 0;
+    for (uint32_t i = 0; i < 50; ++i) {
+        P Poly(1, 0);
+        for (uint32_t j = 0; j < 1 + Rng() % 6; ++j) {
+            const P Factor = P(1, 1) - P(R(I(RandomInt(20)), I(2)), 0);
+            Poly *= Rng() % 4 == 0 ? Factor * Factor : Factor;
+        }
+        for (uint32_t j = 0; j < Rng() % 3; ++j) {
+            const P Shifted = P(1, 1) - P(R(RandomInt(10)), 0);
+            const int64_t Height = 2 + Rng() % 2;
+            Poly *= Shifted * Shifted + P(R(Height * Height), 0);
+        }
+
+        CR Roots(Poly);
+        const auto Sturm = P::MakeSturmSequence(P::SquareFreePart(Poly));
+        for (uint32_t j = 0; j < 20; ++j) {
+            R Lower(I(3 * RandomInt(12) + 1), I(3));
+            R Upper(I(3 * RandomInt(12) + 1), I(3));
+            if (Lower == Upper) continue;
+            if (Upper < Lower) std::swap(Lower, Upper);
+            Mismatches += Roots.Count({ Z(Lower, R(-1)), Z(Upper, R(1)) }) != P::MinNumRootsEnclosed(Sturm, Lower, Upper);
+        }
+    }
+    std::cout << "Checked box counts across the real axis, " << Mismatches << " mismatches\n";
+
+    // Random integer polynomials, every isolating box of height 0 is a real root
+    Mismatches = 0;
+    for (uint32_t i = 0; i < 30; ++i) {
+        P Poly(1, 3 + Rng() % 6);
+        for (uint32_t Exp = 0; Exp < Poly.Degree(); ++Exp) Poly += P(R(RandomInt(9)), Exp);
+
+        CR Roots(Poly);
+        const P Simple = P::SquareFreePart(Poly);
+        R Bound = P::CauchyBounds(Simple);
+        Bound.ApplyAbs();
+        Bound = Bound + 1;
+
+        const auto Boxes = Roots.Isolate(R(I(1), I(1000)));
+        const int32_t RealBoxes = int32_t(std::count_if(Boxes.begin(), Boxes.end(), [](const CR::Box& Region) {
+            return Region.Lo.Imag.IsZero() && Region.Hi.Imag.IsZero();
+        }));
+        Mismatches += RealBoxes != P::MinNumRootsEnclosed(P::MakeSturmSequence(Simple), -Bound, Bound);
+        Mismatches += Boxes.size() != Simple.Degree() || Roots.Count({ Z(-Bound, -Bound), Z(Bound, Bound) }) != int32_t(Simple.Degree());
+    }
+    std::cout << "Checked real isolating boxes against Sturm counts, " << Mismatches << " mismatches\n";
+
+    // Each expected root has to be matched by its own approximation
+    Mismatches = 0;
+    const double Half = std::sqrt(0.5);
+    const double Sixty = std::sqrt(0.75);
+    const std::vector<std::pair<P, std::vector<std::pair<double, double>>>> Known {
+        { P(1, 4) + P(1, 0), { { Half, Half }, { Half, -Half }, { -Half, Half }, { -Half, -Half } } },
+        { P(1, 3) - P(1, 0), { { 1, 0 }, { -0.5, Sixty }, { -0.5, -Sixty } } },
+        { P::Pow(P(1, 2) + P(1, 0), 2) * (P(1, 1) - P(3, 0)), { { 0, 1 }, { 0, -1 }, { 3, 0 } } },
+    };
+    for (const auto& [Poly, Expected] : Known) {
+        const auto Start = std::chrono::steady_clock::now();
+        const std::vector<Z> Found = CR(Poly).Evaluate(R(I(1), I(1000000000)));
+        const double Milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start).count();
+
+        std::cout << P::ToString(Poly) << " in " << Milliseconds << "ms:\n";
+        for (const Z& Root : Found) std::cout << "  " << Z::ToString(Root) << "\n";
+
+        std::vector<bool> Used(Found.size(), false);
+        Mismatches += Found.size() != Expected.size();
+        for (const auto& [Real, Imag] : Expected) {
+            bool Matched = false;
+            for (size_t i = 0; i < Found.size() && !Matched; ++i) {
+                if (Used[i] || std::abs(Found[i].Real.ToDouble() - Real) > 1e-9 || std::abs(Found[i].Imag.ToDouble() - Imag) > 1e-9) continue;
+                Used[i] = Matched = true;
+            }
+            Mismatches += !Matched;
+        }
+    }
+    std::cout << "Checked isolated roots against closed forms, " << Mismatches << " mismatches\n";
+}
+
+// Round trips random polynomials and their Sturm sequences through an archive file, and times the binary form
+// against decimal strings for the same integers
+void BenchSerialize() {
+    std::mt19937_64 Rng(1);
+    auto RandomInteger = [&](uint32_t Words) {
+        I Res = 0;
+        for (uint32_t i = 0; i < Words; ++i) Res = Res * I(uint64_t(1) << 32) + I(uint32_t(Rng()));
+        return Rng() & 1 ? -Res : Res;
+    };
+
+    // Edge cases first, then the bulk
+    bool Same = true;
+    for (const I& Val : { I(0), I(1), I(-1), I(255), I(256), I(UINT32_MAX), I(uint64_t(1) << 32), -I::Power2(64), RandomInteger(40) }) {
+        WireWriter Out;
+        Out.Write(Val);
+        WireReader In(Out.Bytes());
+        Same = Same && BigIntView::Read(In).Get<I>() == Val && In.AtEnd();
+    }
+
+    std::vector<P> Polys;
+    std::vector<std::vector<P>> Sequences;
+    for (uint32_t i = 0; i < 200; ++i) {
+        P Poly;
+        for (uint32_t Exp = 0; Exp <= 10; ++Exp) {
+            if (Rng() % 4 == 0) continue;
+            Poly += P(R(RandomInteger(1), I(int64_t(Rng() % 1000 + 1))), Exp);
+        }
+        Polys.push_back(Poly);
+        Sequences.push_back(P::MakeSturmSequence(Poly));
+    }
+
+    auto Start = std::chrono::steady_clock::now();
+    ArchiveWriter Archive;
+    for (size_t i = 0; i < Polys.size(); ++i) {
+        Archive.Add(Polys[i]);
+        Archive.Add(Sequences[i]);
+    }
+    const std::vector<uint8_t> Bytes = Archive.Finish();
+    auto Written = std::chrono::steady_clock::now();
+
+    const std::filesystem::path Path = std::filesystem::temp_directory_path() / "algebraic-serialize.bin";
+    {
+        std::ofstream File(Path, std::ios::binary);
+        File.write(reinterpret_cast<const char*>(Bytes.data()), static_cast<std::streamsize>(Bytes.size()));
+    }
+
+    size_t Terms = 0;
+    size_t Integers = 0;
+    double WalkMs = 0, ReadMs = 0;
+    {
+        const MappedFile Mapped(Path.string());
+        const ArchiveView View(Mapped.Bytes());
+
+        // Views only, touching every term without building a single number
+        auto WalkStart = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < View.Size(); ++i) {
+            WireReader In = View.Record(i);
+            auto CountTerms = [&](const PolynomialView<>& Poly) {
+                Poly.ForEachTerm([&](uint32_t, const RationalView& Cof) { Terms += Cof.Sign() != 0; });
+            };
+            if (i % 2 == 0) {
+                CountTerms(PolynomialView<>::Read(In));
+            } else {
+                const SturmView<> Sequence = SturmView<>::Read(In);
+                for (size_t j = 0; j < Sequence.Size(); ++j) CountTerms(Sequence[j]);
+            }
+        }
+        auto WalkEnd = std::chrono::steady_clock::now();
+
+        std::vector<P> BackPolys;
+        std::vector<std::vector<P>> BackSequences;
+        for (size_t i = 0; i < View.Size(); ++i) {
+            WireReader In = View.Record(i);
+            if (i % 2 == 0) {
+                BackPolys.push_back(PolynomialView<>::Read(In).Get<P>());
+            } else {
+                BackSequences.push_back(SturmView<>::Read(In).Get<P>());
+            }
+        }
+        auto ReadEnd = std::chrono::steady_clock::now();
+
+        for (size_t i = 0; i < Polys.size(); ++i) {
+            Same = Same && (BackPolys[i] - Polys[i]).IsZero() && BackSequences[i].size() == Sequences[i].size();
+            for (size_t j = 0; Same && j < Sequences[i].size(); ++j) {
+                Same = (BackSequences[i][j] - Sequences[i][j]).IsZero();
+            }
+        }
+
+        WalkMs = std::chrono::duration<double, std::milli>(WalkEnd - WalkStart).count();
+        ReadMs = std::chrono::duration<double, std::milli>(ReadEnd - WalkEnd).count();
+    }
+    std::filesystem::remove(Path);
+
+    // The same integers through decimal strings
+    size_t DecimalBytes = 0;
+    auto DecimalStart = std::chrono::steady_clock::now();
+    for (const std::vector<P>& Sequence : Sequences) {
+        for (const P& Poly : Sequence) {
+            for (const auto& t : Poly.GetTerms()) {
+                for (const I& Val : { t.Cof.Numerator(), t.Cof.Denominator() }) {
+                    const std::string Str = I::ToString(Val);
+                    DecimalBytes += Str.size() + 1;
+                    const I Back = Str[0] == '-' ? -I::FromString(Str.substr(1)) : I::FromString(Str);
+                    Same = Same && Back == Val;
+                    ++Integers;
+                }
+            }
+        }
+    }
+    auto DecimalEnd = std::chrono::steady_clock::now();
+
+    const double WriteMs = std::chrono::duration<double, std::milli>(Written - Start).count();
+    const double MB = Bytes.size() / 1e6;
+    std::cout << "archive: " << Bytes.size() << " bytes, " << Polys.size() * 2 << " records, " << Terms << " terms"
+        << (Same ? "" : ", MISMATCH") << "\n";
+    std::cout << "write " << WriteMs << "ms (" << MB / WriteMs * 1e3 << " MB/s)"
+        << ", walk views " << WalkMs << "ms (" << MB / WalkMs * 1e3 << " MB/s)"
+        << ", read back " << ReadMs << "ms (" << MB / ReadMs * 1e3 << " MB/s)\n";
+    std::cout << "decimal round trip of the " << Integers << " Sturm integers: " << DecimalBytes << " bytes, "
+        << std::chrono::duration<double, std::milli>(DecimalEnd - DecimalStart).count() << "ms\n";
+}
+
+// Cz::C on machine words against the step-by-step BigInt reference, same results and steps per second
+void BenchCollatz() {
+    std::mt19937_64 Rng(1);
+
+    std::vector<uint64_t> Small;
+    for (uint64_t Val = 1; Val <= 20000; ++Val) Small.push_back(Val);
+    std::vector<uint64_t> Large;
+    for (uint32_t i = 0; i < 2000; ++i) Large.push_back((Rng() >> 4) | (uint64_t(1) << 59));
+    // These climb past 2^64 and some past 2^128
+    std::vector<uint64_t> Edge = { UINT64_MAX, UINT64_MAX - 2, (UINT64_MAX / 3) | 1, 0x8000000000000001ull };
+
+    size_t Mismatches = 0;
+    for (const auto* Starts : { &Small, &Large, &Edge }) {
+        for (uint64_t Val : *Starts) {
+            const Cz::Result Fast = Cz::C(Val);
+            const Cz::Result Ref = Cz::CBigInt(I(Val));
+            if (Fast.M != Ref.M || Fast.D != Ref.D || Fast.B != Ref.B) {
+                std::cout << "MISMATCH at " << Val << "\n";
+                ++Mismatches;
+            }
+        }
+    }
+    // Wide starts spend most of their steps in the BigInt part of Cz::C
+    std::vector<I> Wide = { I::Power2(200) + I(1), I::Pow(I(3), 120), I::Power2(64) + I(27) };
+    for (uint32_t i = 0; i < 200; ++i) {
+        I Val = 1;
+        for (uint32_t Word = 0; Word < 8; ++Word) Val = (Val << 32) + I(uint32_t(Rng()));
+        Wide.push_back(Val);
+    }
+    for (const I& Val : Wide) {
+        const Cz::Result Fast = Cz::C(Val);
+        const Cz::Result Ref = Cz::CBigInt(Val);
+        if (Fast.M != Ref.M || Fast.D != Ref.D || Fast.B != Ref.B) {
+            std::cout << "MISMATCH at " << I::ToString(Val) << "\n";
+            ++Mismatches;
+        }
+    }
+    std::cout << "Checked " << Small.size() + Large.size() + Edge.size() + Wide.size() << " trajectories, " << Mismatches << " mismatches\n";
+
+    auto Measure = [](const char* Name, const auto& Starts, auto Run) {
+        size_t Steps = 0;
+        auto Start = std::chrono::steady_clock::now();
+        for (const auto& Val : Starts) {
+            const Cz::Result Res = Run(Val);
+            Steps += Res.M + Res.D;
+        }
+        const double Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+        std::cout << Name << ": " << Steps << " steps in " << Seconds * 1000 << "ms, " << Steps / Seconds / 1e6 << "M steps/s\n";
+    };
+
+    Measure("BigInt, starts below 20000", Small, [](uint64_t Val) { return Cz::CBigInt(I(Val)); });
+    Measure("Native, starts below 20000", Small, [](uint64_t Val) { return Cz::C(Val); });
+    Measure("BigInt, 60-bit starts", Large, [](uint64_t Val) { return Cz::CBigInt(I(Val)); });
+    Measure("Native, 60-bit starts", Large, [](uint64_t Val) { return Cz::C(Val); });
+    Measure("Native, overflowing starts", Edge, [](uint64_t Val) { return Cz::C(Val); });
+
+    // Bigger sets for the tables, the jumps are short enough that a few milliseconds of work is mostly noise
+    std::vector<uint64_t> ManySmall;
+    for (uint64_t Val = 1; Val <= 300000; ++Val) ManySmall.push_back(Val);
+    std::vector<uint64_t> ManyLarge;
+    for (uint32_t i = 0; i < 100000; ++i) ManyLarge.push_back((Rng() >> 4) | (uint64_t(1) << 59));
+
+    Measure("Native, starts below 300000", ManySmall, [](uint64_t Val) { return Cz::C(Val); });
+    Measure("Native, 100000 60-bit starts", ManyLarge, [](uint64_t Val) { return Cz::C(Val); });
+    for (size_t Bits = 16; Bits <= 24; Bits += 2) {
+        auto Start = std::chrono::steady_clock::now();
+        const Cz::JumpTable Table(Bits);
+        std::cout << "Jump table k=" << Bits << ": " << (Table.Bytes() >> 10) << "KB, built in "
+            << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start).count() << "ms\n";
+
+        size_t TableMismatches = 0;
+        for (const auto* Starts : { &Small, &Large, &Edge }) {
+            for (uint64_t Val : *Starts) {
+                const Cz::Result Fast = Cz::C(Val, Table);
+                const Cz::Result Ref = Cz::C(Val);
+                TableMismatches += Fast.M != Ref.M || Fast.D != Ref.D || Fast.B != Ref.B;
+            }
+        }
+        if (TableMismatches) std::cout << "MISMATCH in " << TableMismatches << " trajectories\n";
+
+        Measure("  starts below 300000", ManySmall, [&](uint64_t Val) { return Cz::C(Val, Table); });
+        Measure("  100000 60-bit starts", ManyLarge, [&](uint64_t Val) { return Cz::C(Val, Table); });
+    }
+
+    // CMany takes ranges, so these are consecutive starts, the lanes only pay off when built with AVX2 or AVX-512
+    for (uint64_t Base : { uint64_t(1), uint64_t(1) << 59, UINT64_MAX - 300000 }) {
+        size_t Steps = 0;
+        size_t LaneMismatches = 0;
+        auto Start = std::chrono::steady_clock::now();
+        Cz::CMany(Base, Base + 300000, [&](uint64_t Val, const Cz::Result& Res) {
+            Steps += Res.M + Res.D;
+            const Cz::Result Ref = Cz::C(Val);
+            LaneMismatches += Res.M != Ref.M || Res.D != Ref.D || Res.B != Ref.B;
+        });
+        const double Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+        std::cout << "Lanes x" << Cz::LaneWidth << ", 300000 starts from " << Base << " (with checks): " << Steps << " steps in "
+            << Seconds * 1000 << "ms, " << LaneMismatches << " mismatches\n";
+
+        Start = std::chrono::steady_clock::now();
+        Steps = 0;
+        Cz::CMany(Base, Base + 300000, [&](uint64_t, const Cz::Result& Res) { Steps += Res.M + Res.D; });
+        const double Bare = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+        std::cout << "  without checks: " << Bare * 1000 << "ms, " << Steps / Bare / 1e6 << "M steps/s\n";
+    }
+
+    Measure("BigInt, 288-bit starts", Wide, [](const I& Val) { return Cz::CBigInt(Val); });
+    Measure("Fused, 288-bit starts", Wide, [](const I& Val) { return Cz::C(Val); });
+    Measure("Lazy, 288-bit starts", Wide, [](const I& Val) { return MutliCollatz::C(Val); });
+
+    // Fused costs a pass over the value per multiply step, lazy one per ~50 steps of either kind
+    std::vector<I> Huge;
+    for (size_t Bits : { 10000, 100000 }) {
+        I Val = 1;
+        for (size_t Word = 0; Word < Bits / 32; ++Word) Val = (Val << 32) + I(uint32_t(Rng()));
+        Huge.push_back(Val);
+    }
+    size_t LazyMismatches = 0;
+    for (const auto* Starts : { &Wide, &Huge }) {
+        for (const I& Val : *Starts) {
+            const Cz::Result Lazy = MutliCollatz::C(Val);
+            const Cz::Result Ref = Cz::C(Val);
+            LazyMismatches += Lazy.M != Ref.M || Lazy.D != Ref.D || Lazy.B != Ref.B;
+        }
+    }
+    if (LazyMismatches) std::cout << "MISMATCH in " << LazyMismatches << " lazy trajectories\n";
+    Measure("Fused, 10000 and 100000-bit starts", Huge, [](const I& Val) { return Cz::C(Val); });
+    Measure("Lazy, 10000 and 100000-bit starts", Huge, [](const I& Val) { return MutliCollatz::C(Val); });
+}
+
+// Checks Block<N> against plain Collatz steps and brute force, then times the shortest residual from every block to Target
+template<size_t N>
+void BenchResidual(uint64_t Target, size_t Threads) {
+    using Blk = Cz::Block<N>;
+    std::mt19937_64 Rng(1);
+
+    // x = H * 2^N + B after the N halvings that shift B out is H * 3^k + r for (k, r) = B.Run()
+    size_t Mismatches = 0;
+    for (uint32_t i = 0; i < 2000; ++i) {
+        const uint64_t High = Rng() % 1000;
+        const Blk Low { Rng() & Blk::Mask };
+        const Cz::Residual Res = Low.Run();
+        I Val = (I(High) << N) + I(Low.Val);
+        for (size_t Halvings = 0; Halvings < N;) {
+            if (Val.GetBit(0)) {
+                Val = Val * I(3) + I(1);
+            } else {
+                Val >>= 1;
+                ++Halvings;
+            }
+        }
+        Mismatches += Val != I(High) * I::Pow(I(3), Res.Steps) + I(Res.Val);
+
+        const size_t Steps = Rng() % (Cz::MaxResidualSteps + 1);
+        const Cz::Residual In { Steps, Rng() % Cz::Pow3Table[Steps] };
+        const auto [Out, After] = Low.Apply(In);
+        const I Full = I(Low.Val) * I::Pow(I(3), Steps) + I(In.Val);
+        Mismatches += Blk::Before(In, After) != Low || I(Out.Val) != (Full >> N) || I(After.Val) != Full - ((Full >> N) << N);
+    }
+    // Every residual of each length in turn, as res.py's find_to_shortest does
+    if constexpr (N <= 10) {
+        for (uint64_t From = 0; From <= Blk::Mask; ++From) {
+            const Cz::Residual Fast = Blk::Shortest({ From }, { Target });
+            bool Found = false;
+            for (size_t Steps = 0; Steps <= Fast.Steps && !Found; ++Steps) {
+                for (uint64_t Val = 0; Val < Cz::Pow3Table[Steps] && !Found; ++Val) {
+                    if (Blk { From }.Apply({ Steps, Val }).second.Val != Target) continue;
+                    Found = true;
+                    Mismatches += Fast != Cz::Residual { Steps, Val };
+                }
+            }
+            Mismatches += !Found;
+        }
+    }
+    std::cout << "Checked N=" << N << ", " << Mismatches << " mismatches\n";
+
+    WorkPool Pool(Threads);
+    const auto Start = std::chrono::steady_clock::now();
+    const auto Counts = Blk::ShortestHistogram({ Target }, Pool);
+    const double Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+
+    std::cout << "Shortest residuals from all 2^" << N << " blocks to " << Blk::ToString({ Target }) << " on " << Pool.Size()
+        << " threads in " << Seconds << "s\n";
+    double Mean = 0;
+    for (size_t Steps = 0; Steps < Counts.size(); ++Steps) {
+        if (Counts[Steps] == 0) continue;
+        std::cout << "  " << Steps << " steps: " << Counts[Steps] << "\n";
+        Mean += double(Steps) * Counts[Steps];
+    }
+    std::cout << "  mean " << Mean / double(Blk::Mask + 1) << " steps\n";
+}
+
+// Writes res.py's aft matrix for N-bit blocks to Path, one byte per cell, then checks cells against Block::Shortest
+template<size_t N>
+void WriteShortestMatrix(const std::string& Path, size_t Threads) {
+    using Blk = Cz::Block<N>;
+    constexpr uint64_t Size = Blk::Mask + 1;
+
+    WorkPool Pool(Threads);
+    MappedOutput Out(Path, Size * Size);
+    const auto Start = std::chrono::steady_clock::now();
+    Blk::ShortestMatrix(Out.Bytes(), Pool);
+    const double Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+    std::cout << "Wrote the " << Size << " x " << Size << " shortest residual lengths to " << Path << " on " << Pool.Size()
+        << " threads in " << Seconds << "s, " << double(Size * Size) / Seconds / 1e6 << "M cells/s\n";
+
+    // All of it when small, otherwise a sample
+    std::mt19937_64 Rng(1);
+    const std::span<uint8_t> Cells = Out.Bytes();
+    const uint64_t Checks = std::min<uint64_t>(Size * Size, 1000000);
+    size_t Mismatches = 0;
+    for (uint64_t i = 0; i < Checks; ++i) {
+        const uint64_t Cell = Checks == Size * Size ? i : Rng() & (Size * Size - 1);
+        Mismatches += Cells[Cell] != Blk::Shortest({ Cell >> N }, { Cell & Blk::Mask }).Steps;
+    }
+    std::cout << "Checked " << Checks << " cells, " << Mismatches << " mismatches\n";
+}
+
+int RunShortestMatrix(int argc, char** argv) {
+    if (argc < 4) {
+        std::cout << "Usage: algebraic aft <bits, 1 to 16> <output> [threads]\n";
+        return 1;
+    }
+
+    const size_t Bits = std::stoull(argv[2]);
+    const size_t Threads = argc > 4 ? std::stoull(argv[4]) : std::thread::hardware_concurrency();
+    if (Bits < 1 || Bits > 16) {
+        std::cout << "The matrix takes 4^bits bytes, bits has to be 1 to 16\n";
+        return 1;
+    }
+
+    [&]<size_t... Ns>(std::index_sequence<Ns...>) {
+        ((Bits == Ns + 1 ? WriteShortestMatrix<Ns + 1>(argv[3], Threads) : void()), ...);
+    }(std::make_index_sequence<16> {});
+    return 0;
+}
+
+int RunResidual(int argc, char** argv) {
+    if (argc < 4) {
+        std::cout << "Usage: algebraic residual <bits, 1 to 32> <target block> [threads]\n";
+        return 1;
+    }
+
+    const size_t Bits = std::stoull(argv[2]);
+    const uint64_t Target = std::stoull(argv[3]);
+    const size_t Threads = argc > 4 ? std::stoull(argv[4]) : std::thread::hardware_concurrency();
+    if (Bits < 1 || Bits > 32 || (Target >> Bits) != 0) {
+        std::cout << "The target has to fit in 1 to 32 bits\n";
+        return 1;
+    }
+
+    [&]<size_t... Ns>(std::index_sequence<Ns...>) {
+        ((Bits == Ns + 1 ? BenchResidual<Ns + 1>(Target, Threads) : void()), ...);
+    }(std::make_index_sequence<32> {});
+    return 0;
+}
+
+// algebraic sweep <begin> <end> [threads] [checkpoint] [sieve bits], sweeps [begin, end) and resumes from the checkpoint
+// if there is one, "-" for no checkpoint, with sieve bits it only checks the glides of the starts a sieve that wide keeps
+int RunSweep(int argc, char** argv) {
+    if (argc < 4) {
+        std::cout << "Usage: algebraic sweep <begin> <end> [threads] [checkpoint] [sieve bits] [memo bits]\n";
+        return 1;
+    }
+
+    const uint64_t Begin = std::stoull(argv[2]);
+    const uint64_t End = std::stoull(argv[3]);
+    const size_t Threads = argc > 4 ? std::stoull(argv[4]) : std::thread::hardware_concurrency();
+    const std::string Checkpoint = argc > 5 && std::string(argv[5]) != "-" ? argv[5] : "";
+    const size_t SieveBits = argc > 6 ? std::stoull(argv[6]) : 0;
+    const size_t MemoBits = argc > 7 ? std::stoull(argv[7]) : 0;
+    if (MemoBits > 32) {
+        std::cout << "The memo covers the starts below 2^memo bits, memo bits has to be at most 32\n";
+        return 1;
+    }
+
+    auto Start = std::chrono::steady_clock::now();
+    const std::optional<Cz::Sieve> Residues = SieveBits ? std::optional<Cz::Sieve>(SieveBits) : std::nullopt;
+    if (Residues) {
+        std::cout << "Sieve k=" << SieveBits << " keeps " << Residues->Size() << " residues and " << Residues->Extra().size()
+            << " small starts, " << (Residues->Bytes() >> 10) << "KB, built in "
+            << std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count() << "s\n";
+        Start = std::chrono::steady_clock::now();
+    }
+    // Glides stop below their start anyway, so the memo only goes with full trajectories
+    std::optional<Cz::Memo> Cache;
+    if (MemoBits && !Residues) Cache.emplace(uint64_t(1) << MemoBits);
+    const Cz::SweepResult Res = Cz::Sweep(Begin, End, Threads, Checkpoint, Residues ? &*Residues : nullptr, Cache ? &*Cache : nullptr);
+    const double Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+
+    const char* What = Residues ? "glide " : "";
+    std::cout << "Swept [" << Res.Begin << ", " << Res.End << ") on " << Threads << " threads in " << Seconds << "s\n";
+    std::cout << "Checked " << Res.Checked << " starts, " << Res.Steps << " steps\n";
+    std::cout << "Max " << What << "M " << Res.M.Value << " at " << Res.M.Start << "\n";
+    std::cout << "Max " << What << "D " << Res.D.Value << " at " << Res.D.Start << "\n";
+    std::cout << "Max " << What << "B " << Res.B.Value << " at " << Res.B.Start << "\n";
+    std::cout << "Max " << What << "M + D " << Res.C.Value << " at " << Res.C.Start << "\n";
+    if (Cache) {
+        // Counts cover this run only, a resumed sweep's earlier starts aren't in them
+        const Cz::Memo::Counts Total = Cache->Total();
+        std::cout << "Memo below 2^" << MemoBits << " (" << (Cache->Bytes() >> 20) << "MB): " << Total.Hits << " trajectories hit it, "
+            << Total.Walked << " steps walked\n";
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::string(argv[1]) == "roots") {
+        CheckRoots();
+        return 0;
+    }
+    if (argc > 1 && std::string(argv[1]) == "minpoly") {
+        BenchMinimalPolynomial();
+        return 0;
+    }
+    if (argc > 1 && std::string(argv[1]) == "taylor") {
+        BenchTaylorShift();
+        return 0;
+    }
+    if (argc > 1 && std::string(argv[1]) == "matrix") {
+        CheckMatrix();
+        return 0;
+    }
+    if (argc > 1 && std::string(argv[1]) == "complexroots") {
+        CheckComplexRoots();
+        return 0;
+    }
+    if (argc > 1 && std::string(argv[1]) == "serialize") {
+        BenchSerialize();
+        return 0;
+    }
+    if (argc > 1 && std::string(argv[1]) == "collatz") {
+        BenchCollatz();
+        return 0;
+    }
+
     try {
+        if (argc > 1 && std::string(argv[1]) == "sweep") {
+            return RunSweep(argc, argv);
+        }
+        if (argc > 1 && std::string(argv[1]) == "residual") {
+            return RunResidual(argc, argv);
+        }
+        if (argc > 1 && std::string(argv[1]) == "aft") {
+            return RunShortestMatrix(argc, argv);
+        }
+
         I ValA = 1;
         I ValB = 1;
         size_t BShift = 25;
@@ -5,6 +5,8 @@
 #include <algorithm>
 #include <iostream>
 #include <assert.h>
+#include <cmath>
+#include <bit>
 
 template<typename F, typename H>
 concept WideEnough = std::unsigned_integral<F> && std::unsigned_integral<H> && (sizeof(F) == 2 * sizeof(H));
@@ -82,21 +84,51 @@ public:
     size_t TopBitIndex() const {
         if (IsZero()) throw std::runtime_error("TopBitIndex(0) is undefined");
 
-        size_t LastIndex = Size() - 1;
-        H TopWord = m_Data[LastIndex];
-
-        size_t BitsInTop = 0;
-        while (TopWord != 0) {
-            TopWord >>= 1;
-            ++BitsInTop;
-        }
+        const size_t LastIndex = Size() - 1;
+        return LastIndex * m_wordBits + (m_wordBits - 1 - std::countl_zero(m_Data[LastIndex]));
+    }
+    // The exponent of the largest power of two dividing the value
+    size_t CountTrailingZeros() const {
+        if (IsZero()) throw std::runtime_error("CountTrailingZeros(0) is undefined");
 
-        return BitsInTop + LastIndex * sizeof(H) * 8 - 1;
+        size_t Index = 0;
+        while (m_Data[Index] == 0) ++Index;
+        return Index * m_wordBits + std::countr_zero(m_Data[Index]);
     }
     size_t Log2Unsigned() const {
         if (IsZero()) throw std::runtime_error("Log2Unsigned(0) is undefined");
         return TopBitIndex();
     }
+    // Returns the top (at most) 64 bits of the magnitude as a double, the value is about Res * 2^OutExp
+    // Dropped bits and the conversion together stay within 2 ulps, and it can't overflow no matter the size
+    double ToDoubleScaled(int64_t& OutExp) const {
+        OutExp = 0;
+        if (IsZero()) return 0.0;
+
+        const size_t Top = TopBitIndex();
+        const size_t Shift = Top >= 63 ? Top - 63 : 0;
+
+        BigInt Tmp = *this;
+        Tmp.m_Sign = false;
+        Tmp.ApplyShiftRight(Shift);
+
+        uint64_t Bits = 0;
+        for (size_t i = Tmp.Size(); i-- > 0;) {
+            if constexpr (m_wordBits >= 64) {
+                Bits = Tmp.m_Data[i];
+            } else {
+                Bits = (Bits << m_wordBits) | Tmp.m_Data[i];
+            }
+        }
+
+        OutExp = static_cast<int64_t>(Shift);
+        return m_Sign ? -static_cast<double>(Bits) : static_cast<double>(Bits);
+    }
+    double ToDouble() const {
+        int64_t Exp;
+        const double Res = ToDoubleScaled(Exp);
+        return std::ldexp(Res, static_cast<int>(std::min<int64_t>(Exp, 1 << 20)));
+    }
     // return sign(abs(LHS) - abs(RHS))
     static int32_t DiffMagnitude(const BigInt& LHS, const BigInt& RHS) {
         if (LHS.Size() != RHS.Size()) {
@@ -140,6 +172,14 @@ public:
     }
 
     // Static functions
+    // Magnitude from its words, lowest first, trailing zero words are dropped
+    static BigInt FromWords(std::vector<H> Words, bool Negative) {
+        BigInt Res;
+        Res.m_Data = std::move(Words);
+        Res.m_Sign = Negative;
+        Res.normalize();
+        return Res;
+    }
     // Return 2^Exp
     static BigInt Power2(size_t Exp) {
         BigInt Res;
@@ -239,6 +279,132 @@ public:
 
         normalize();
     }
+    // Replaces the magnitude with (|this| * Mul + Add) / 2^k for the largest such k, and returns k
+    // A single pass: the low words of the product come out first, so k is known before any word has to be placed
+    // and the shifted result is written behind the read position
+    size_t ApplyMulAddShiftOut(H Mul, H Add) {
+        H Pending = 0;
+        size_t WordShift = 0;
+        size_t BitShift = 0;
+        bool Found = false;
+        size_t Out = 0;
+
+        auto Place = [&](H Word) {
+            if (!Found) {
+                if (Word == 0) {
+                    ++WordShift;
+                    return;
+                }
+                Found = true;
+                BitShift = std::countr_zero(Word);
+                Pending = Word >> BitShift;
+                return;
+            }
+            if (BitShift == 0) {
+                m_Data[Out++] = Pending;
+                Pending = Word;
+            } else {
+                m_Data[Out++] = Pending | static_cast<H>(Word << (m_wordBits - BitShift));
+                Pending = Word >> BitShift;
+            }
+        };
+
+        H Carry = Add;
+        for (size_t i = 0; i < m_Data.size(); ++i) {
+            const F Sum = static_cast<F>(m_Data[i]) * Mul + Carry;
+            Carry = msb(Sum);
+            Place(lsb(Sum));
+        }
+        Place(Carry);
+        if (!Found) throw std::runtime_error("ApplyMulAddShiftOut of a zero result");
+
+        if (Out == m_Data.size()) {
+            m_Data.push_back(Pending);
+        } else {
+            m_Data[Out] = Pending;
+            m_Data.resize(Out + 1);
+        }
+        normalize();
+
+        return WordShift * m_wordBits + BitShift;
+    }
+    // Schoolbook long division of magnitudes, Knuth's algorithm D, one quotient word per step
+    // Num is replaced by the remainder and the quotient is returned, Num must be at least as long as Den
+    // The divisor is shifted so its top bit is set, then the top two remainder words over the top divisor word
+    // overestimate the quotient word by at most 2, and checking against the second divisor word leaves at most 1
+    static std::vector<H> DivRemWords(std::vector<H>& Num, const std::vector<H>& Den) {
+        const size_t N = Den.size();
+        const size_t M = Num.size() - N;
+        std::vector<H> Quotient(M + 1, 0);
+
+        if (N == 1) {
+            F Rem = 0;
+            for (size_t i = Num.size(); i-- > 0;) {
+                const F Cur = (Rem << m_wordBits) | Num[i];
+                Quotient[i] = static_cast<H>(Cur / Den[0]);
+                Rem = Cur % Den[0];
+            }
+            Num.assign(1, static_cast<H>(Rem));
+            return Quotient;
+        }
+
+        const uint32_t Shift = static_cast<uint32_t>(std::countl_zero(Den.back()));
+        auto ShiftUp = [Shift](const std::vector<H>& Src, size_t Size) {
+            std::vector<H> Res(Size, 0);
+            for (size_t i = 0; i < Src.size(); ++i) {
+                const F Wide = static_cast<F>(Src[i]) << Shift;
+                Res[i] |= lsb(Wide);
+                if (i + 1 < Size) Res[i + 1] = msb(Wide);
+            }
+            return Res;
+        };
+        const std::vector<H> V = ShiftUp(Den, N);
+        std::vector<H> U = ShiftUp(Num, Num.size() + 1);
+
+        const F Base = F(1) << m_wordBits;
+        for (size_t j = M + 1; j-- > 0;) {
+            const F Top = (static_cast<F>(U[j + N]) << m_wordBits) | U[j + N - 1];
+            F Guess = Top / V[N - 1];
+            F Rest = Top % V[N - 1];
+            while (Guess >= Base || Guess * V[N - 2] > ((Rest << m_wordBits) | U[j + N - 2])) {
+                --Guess;
+                Rest += V[N - 1];
+                if (Rest >= Base) break;
+            }
+
+            // U[j..j+N] -= Guess * V
+            F Carry = 0;
+            H Borrow = 0;
+            for (size_t i = 0; i < N; ++i) {
+                const F Product = Guess * V[i] + Carry;
+                Carry = msb(Product);
+                const F Diff = static_cast<F>(U[i + j]) - lsb(Product) - Borrow;
+                U[i + j] = lsb(Diff);
+                Borrow = msb(Diff) != 0 ? 1 : 0;
+            }
+            const F Diff = static_cast<F>(U[j + N]) - Carry - Borrow;
+            U[j + N] = lsb(Diff);
+
+            // Guess was one too large, add a V back
+            if (msb(Diff) != 0) {
+                --Guess;
+                F Sum = 0;
+                for (size_t i = 0; i < N; ++i) {
+                    Sum = static_cast<F>(U[i + j]) + V[i] + msb(Sum);
+                    U[i + j] = lsb(Sum);
+                }
+                U[j + N] = lsb(static_cast<F>(U[j + N]) + msb(Sum));
+            }
+            Quotient[j] = static_cast<H>(Guess);
+        }
+
+        Num.assign(N, 0);
+        for (size_t i = 0; i < N; ++i) {
+            Num[i] = static_cast<H>((U[i] >> Shift) | (Shift == 0 ? 0 : static_cast<H>(static_cast<F>(U[i + 1]) << (m_wordBits - Shift))));
+        }
+        return Quotient;
+    }
+
     // Compute the remainder of *this / Divisor, and assign to this
     // Output the quotient in the final parameter, if specified
     void ApplyRemainder(const BigInt& Divisor, BigInt* OutQuotient = nullptr) {
@@ -260,35 +426,13 @@ public:
         
         const bool RemainderSign = m_Sign;
 
-        if (OutQuotient) OutQuotient->ApplyZero(); 
-        m_Sign = false;
-
-        const size_t DivisorBits = Divisor.TopBitIndex() + 1;
-
-        BigInt Operand;
-        while (DiffMagnitude(*this, Divisor) >= 0) {
-            const size_t RemainderBits = TopBitIndex() + 1;
-
-            Operand = Divisor;
-            Operand.ApplySign(true);
-
-            if (RemainderBits > DivisorBits + 1) {
-                const size_t BitDiff = RemainderBits - DivisorBits - 1;
-                Operand.ApplyShiftLeft(BitDiff);
-
-                if (OutQuotient) (*OutQuotient) += Power2(BitDiff);
-                (*this) += Operand;
-            } else {
-                if (OutQuotient) (*OutQuotient) += BigInt(1);
-                (*this) += Operand;
-            }
-
-            if (IsZero()) {
-                break;
-            }
+        std::vector<H> Quotient;
+        if (DiffMagnitude(*this, Divisor) >= 0) {
+            Quotient = DivRemWords(m_Data, Divisor.m_Data);
         }
 
         if (OutQuotient) {
+            OutQuotient->m_Data = std::move(Quotient);
             OutQuotient->m_Sign = QuotientSign;
             OutQuotient->normalize();
         }
@@ -296,6 +440,58 @@ public:
         m_Sign = RemainderSign;
         normalize();
     }
+    // Num / Den for a Den known to divide Num, wrong results otherwise
+    // Hensel division from the low word up: each quotient word is the low remainder word times the inverse of the
+    // divisor's low word mod 2^w, so there is no trial quotient or correction step, only one multiply-subtract per word
+    static BigInt DivideExact(BigInt Num, BigInt Den) {
+        if (Den.IsZero()) throw std::runtime_error("Divide by zero");
+        if (Num.IsZero()) return Num;
+
+        const bool Sign = Num.m_Sign ^ Den.m_Sign;
+
+        // Make Den odd so its low word is invertible, Num loses the same factor of two exactly
+        const size_t Zeros = Den.CountTrailingZeros();
+        Num.ApplyShiftRight(Zeros);
+        Den.ApplyShiftRight(Zeros);
+
+        // Newton iteration for the inverse, each step doubles the correct low bits starting from 3
+        H Inverse = Den.m_Data[0];
+        for (size_t Bits = 3; Bits < m_wordBits; Bits *= 2) {
+            Inverse *= static_cast<H>(2 - Den.m_Data[0] * Inverse);
+        }
+
+        if (Num.Size() < Den.Size()) return BigInt();
+        std::vector<H>& Rem = Num.m_Data;
+        // Read past its top word as 0, the non-const operator[] would grow it instead
+        const BigInt& Divisor = Den;
+        const size_t QuotientSize = Rem.size() - Divisor.Size() + 1;
+
+        BigInt Res;
+        Res.m_Data.resize(QuotientSize, 0);
+        for (size_t i = 0; i < QuotientSize; ++i) {
+            const H Digit = static_cast<H>(Rem[i] * Inverse);
+            Res.m_Data[i] = Digit;
+            if (Digit == 0) continue;
+
+            // Rem -= Digit * Den << (i words)
+            F Carry = 0;
+            H Borrow = 0;
+            for (size_t j = 0; i + j < Rem.size(); ++j) {
+                if (j >= Divisor.Size() && Carry == 0 && Borrow == 0) break;
+
+                const F Product = static_cast<F>(Digit) * Divisor[j] + Carry;
+                Carry = msb(Product);
+
+                const F Diff = static_cast<F>(Rem[i + j]) - lsb(Product) - Borrow;
+                Rem[i + j] = lsb(Diff);
+                Borrow = msb(Diff) != 0 ? 1 : 0;
+            }
+        }
+
+        Res.m_Sign = Sign;
+        Res.normalize();
+        return Res;
+    }
     void ApplyTruncateBits(size_t Bits) {
         if (IsZero()) return;
 
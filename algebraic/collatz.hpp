@@ -4,9 +4,24 @@
 #include "rational.hpp"
 #include "complex.hpp"
 #include "polynomial.hpp"
+#include "workpool.hpp"
 
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <vector>
 
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
 // C(x) = M(x) + D(x)
 // C(1) = 0, M(1) = 0, D(1) = 0
 // C(2) = 1, M(2) = 0, D(2) = 1
@@ -138,7 +153,8 @@ namespace Cz {
         }
     }
 
-    static Result C(I Val) {
+    // One step at a time on BigInt, kept as the reference for the word-sized engine below
+    static Result CBigInt(I Val) {
         Result Res = {0, 0, Val.TopBitIndex()};
 
         while (Val != I(1)) {
@@ -156,7 +172,912 @@ namespace Cz {
 
         return Res;
     }
+
+#ifdef __SIZEOF_INT128__
+    using Wide = unsigned __int128;
+#endif
+
+    template<typename W>
+    size_t TrailingZeros(W Val) {
+        if constexpr (sizeof(W) > sizeof(uint64_t)) {
+            const uint64_t Low = static_cast<uint64_t>(Val);
+            return Low != 0 ? std::countr_zero(Low) : 64 + std::countr_zero(static_cast<uint64_t>(Val >> 64));
+        } else {
+            return std::countr_zero(Val);
+        }
+    }
+
+    // Runs Val down to 1 in a machine word, an odd step and the run of halvings after it at a time
+    // Stops and returns false, with Val odd and still to be multiplied, if 3 * Val + 1 would overflow W
+    template<typename W>
+    bool RunWord(W& Val, Result& Res) {
+        constexpr W Limit = (~W(0) - 1) / 3;
+
+        while (Val != 1) {
+            if (Val & 1) {
+                if (Val > Limit) return false;
+                Val = 3 * Val + 1;
+                Res.M += 1;
+            }
+            const size_t Zeros = TrailingZeros(Val);
+            Val >>= Zeros;
+            Res.D += Zeros;
+        }
+
+        return true;
+    }
+
+    // Steps Val on BigInt until it fits in 64 bits again
+    // Each odd step and the halvings after it are one fused pass over the words
+    void RunBig(I& Val, Result& Res) {
+        if (Val.TopBitIndex() < 64) return;
+
+        const size_t Zeros = Val.CountTrailingZeros();
+        Val.ApplyShiftRight(Zeros);
+        Res.D += Zeros;
+
+        while (Val.TopBitIndex() >= 64) {
+            Res.D += Val.ApplyMulAddShiftOut(3, 1);
+            Res.M += 1;
+        }
+    }
+
+    // Val must fit in 64 bits
+    uint64_t ToWord(const I& Val) {
+        return (static_cast<uint64_t>(Val[1]) << 32) | Val[0];
+    }
+
+    // Takes an odd Val whose 3 * Val + 1 doesn't fit in 64 bits through the stretch of the trajectory above 2^64,
+    // on unsigned __int128 where there is one and BigInt past that, and leaves it back under 2^64
+    void Excursion(uint64_t& Val, Result& Res) {
+        I Big;
+#ifdef __SIZEOF_INT128__
+        constexpr Wide Limit = (~Wide(0) - 1) / 3;
+        Wide Twice = Val;
+        do {
+            if (Twice & 1) {
+                if (Twice > Limit) break;
+                Twice = 3 * Twice + 1;
+                Res.M += 1;
+            }
+            const size_t Zeros = TrailingZeros(Twice);
+            Twice >>= Zeros;
+            Res.D += Zeros;
+        } while ((Twice >> 64) != 0);
+
+        if ((Twice >> 64) == 0) {
+            Val = static_cast<uint64_t>(Twice);
+            return;
+        }
+        Big = (I(static_cast<uint64_t>(Twice >> 64)) << 64) + I(static_cast<uint64_t>(Twice));
+#else
+        Big = I(Val);
+#endif
+        // The step that didn't fit, its halvings can still leave Big past 64 bits
+        Res.D += Big.ApplyMulAddShiftOut(3, 1);
+        Res.M += 1;
+        RunBig(Big, Res);
+        Val = ToWord(Big);
+    }
+
+    void RunFrom(uint64_t Val, Result& Res) {
+        while (!RunWord(Val, Res)) {
+            Excursion(Val, Res);
+        }
+    }
+
+    // Same as CBigInt, but steps run on uint64_t, then unsigned __int128 where there is one, and only the part of the
+    // trajectory that doesn't fit those goes through BigInt
+    // B needs no tracking: a halving keeps TopBitIndex + D the same and 3x+1 can only raise it, so its maximum is
+    // the final D, reached at 1
+    static Result C(uint64_t Val) {
+        if (Val == 0) throw std::runtime_error("Collatz trajectory of zero");
+
+        Result Res;
+        RunFrom(Val, Res);
+        Res.B = Res.D + 1;
+        return Res;
+    }
+
+    static Result C(I Val) {
+        if (Val.Sign() <= 0) throw std::runtime_error("Collatz trajectory of a non-positive value");
+
+        Result Res;
+        RunBig(Val, Res);
+        RunFrom(ToWord(Val), Res);
+        Res.B = Res.D + 1;
+        return Res;
+    }
     
+    // Trajectories side by side for CMany, the kernels keep them in registers and only go through these arrays when a
+    // lane is retired, either at 1 or with a 3x+1 that won't fit, and refilled with the next start
+    // Every lane halves once per iteration, so D is the iterations since the lane was filled
+    template<size_t W>
+    struct Lanes {
+        alignas(64) uint64_t X[W];
+        alignas(64) uint64_t M[W];
+        uint64_t Start[W];
+        uint64_t Filled[W];
+        bool Live[W] = {};
+        uint64_t Iteration = 0;
+        uint64_t Next = 0;
+        uint64_t End = 0;
+
+        // False once the range is used up, which leaves the lane dead
+        template<typename Fn>
+        bool Refill(size_t Lane, Fn& Visit) {
+            while (Next < End) {
+                const uint64_t Val = Next++;
+                if (Val == 1) {
+                    Visit(Val, Result { 0, 0, 1 });
+                    continue;
+                }
+                X[Lane] = Val;
+                M[Lane] = 0;
+                Start[Lane] = Val;
+                Filled[Lane] = Iteration;
+                Live[Lane] = true;
+                return true;
+            }
+            Live[Lane] = false;
+            return false;
+        }
+
+        // The rest of the trajectory, if any, on the scalar path
+        template<typename Fn>
+        void Finish(size_t Lane, Fn& Visit) {
+            Result Res;
+            Res.M = M[Lane];
+            Res.D = Iteration - Filled[Lane];
+            RunFrom(X[Lane], Res);
+            Res.B = Res.D + 1;
+            Visit(Start[Lane], Res);
+        }
+
+        // Retires and refills the lanes in Mask, false if one of them couldn't be refilled
+        template<typename Fn>
+        bool Cycle(uint64_t Mask, Fn& Visit) {
+            bool Refilled = true;
+            for (; Mask != 0; Mask &= Mask - 1) {
+                const size_t Lane = std::countr_zero(Mask);
+                Finish(Lane, Visit);
+                Refilled = Refill(Lane, Visit) && Refilled;
+            }
+            return Refilled;
+        }
+    };
+
+    // x -> (3x + 1) / 2 or x / 2 per lane and iteration, counting M per lane
+    // Stops with the lanes stored back once one can't be refilled
+#if defined(__AVX512F__)
+    constexpr size_t LaneWidth = 16;
+
+    template<typename Fn>
+    void RunLanes(Lanes<LaneWidth>& L, Fn& Visit) {
+        const __m512i One = _mm512_set1_epi64(1);
+        const __m512i Limit = _mm512_set1_epi64((UINT64_MAX - 1) / 3);
+
+        // Two registers of 8 so one's dependency chain hides the other's
+        __m512i X0 = _mm512_load_si512(L.X), X1 = _mm512_load_si512(L.X + 8);
+        __m512i M0 = _mm512_load_si512(L.M), M1 = _mm512_load_si512(L.M + 8);
+        auto Store = [&] {
+            _mm512_store_si512(L.X, X0);
+            _mm512_store_si512(L.X + 8, X1);
+            _mm512_store_si512(L.M, M0);
+            _mm512_store_si512(L.M + 8, M1);
+        };
+        auto Load = [&] {
+            X0 = _mm512_load_si512(L.X);
+            X1 = _mm512_load_si512(L.X + 8);
+            M0 = _mm512_load_si512(L.M);
+            M1 = _mm512_load_si512(L.M + 8);
+        };
+
+        while (true) {
+            const __mmask8 Odd0 = _mm512_test_epi64_mask(X0, One);
+            const __mmask8 Odd1 = _mm512_test_epi64_mask(X1, One);
+            const uint64_t Wide = _mm512_mask_cmpgt_epu64_mask(Odd0, X0, Limit) | (uint64_t(_mm512_mask_cmpgt_epu64_mask(Odd1, X1, Limit)) << 8);
+            if (Wide) {
+                Store();
+                if (!L.Cycle(Wide, Visit)) return;
+                Load();
+                continue;
+            }
+
+            X0 = _mm512_mask_add_epi64(X0, Odd0, X0, _mm512_add_epi64(_mm512_add_epi64(X0, X0), One));
+            X1 = _mm512_mask_add_epi64(X1, Odd1, X1, _mm512_add_epi64(_mm512_add_epi64(X1, X1), One));
+            X0 = _mm512_srli_epi64(X0, 1);
+            X1 = _mm512_srli_epi64(X1, 1);
+            M0 = _mm512_mask_add_epi64(M0, Odd0, M0, One);
+            M1 = _mm512_mask_add_epi64(M1, Odd1, M1, One);
+            ++L.Iteration;
+
+            const uint64_t Done = _mm512_cmpeq_epi64_mask(X0, One) | (uint64_t(_mm512_cmpeq_epi64_mask(X1, One)) << 8);
+            if (Done) {
+                Store();
+                if (!L.Cycle(Done, Visit)) return;
+                Load();
+            }
+        }
+    }
+#elif defined(__AVX2__)
+    constexpr size_t LaneWidth = 8;
+
+    template<typename Fn>
+    void RunLanes(Lanes<LaneWidth>& L, Fn& Visit) {
+        const __m256i One = _mm256_set1_epi64x(1);
+        // No unsigned compare, so both sides get their sign bit flipped
+        const __m256i Sign = _mm256_set1_epi64x(INT64_MIN);
+        const __m256i Limit = _mm256_xor_si256(_mm256_set1_epi64x((UINT64_MAX - 1) / 3), Sign);
+
+        __m256i X[2], M[2];
+        auto Store = [&] {
+            for (size_t r = 0; r < 2; ++r) {
+                _mm256_store_si256(reinterpret_cast<__m256i*>(L.X + 4 * r), X[r]);
+                _mm256_store_si256(reinterpret_cast<__m256i*>(L.M + 4 * r), M[r]);
+            }
+        };
+        auto Load = [&] {
+            for (size_t r = 0; r < 2; ++r) {
+                X[r] = _mm256_load_si256(reinterpret_cast<const __m256i*>(L.X + 4 * r));
+                M[r] = _mm256_load_si256(reinterpret_cast<const __m256i*>(L.M + 4 * r));
+            }
+        };
+        Load();
+
+        while (true) {
+            __m256i Odd[2], OddMask[2];
+            uint64_t Wide = 0;
+            for (size_t r = 0; r < 2; ++r) {
+                Odd[r] = _mm256_and_si256(X[r], One);
+                OddMask[r] = _mm256_sub_epi64(_mm256_setzero_si256(), Odd[r]);
+                const __m256i Over = _mm256_and_si256(OddMask[r], _mm256_cmpgt_epi64(_mm256_xor_si256(X[r], Sign), Limit));
+                Wide |= uint64_t(_mm256_movemask_pd(_mm256_castsi256_pd(Over))) << (4 * r);
+            }
+            if (Wide) {
+                Store();
+                if (!L.Cycle(Wide, Visit)) return;
+                Load();
+                continue;
+            }
+
+            uint64_t Done = 0;
+            for (size_t r = 0; r < 2; ++r) {
+                X[r] = _mm256_add_epi64(X[r], _mm256_and_si256(OddMask[r], _mm256_add_epi64(_mm256_add_epi64(X[r], X[r]), One)));
+                X[r] = _mm256_srli_epi64(X[r], 1);
+                M[r] = _mm256_add_epi64(M[r], Odd[r]);
+                Done |= uint64_t(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(X[r], One)))) << (4 * r);
+            }
+            ++L.Iteration;
+
+            if (Done) {
+                Store();
+                if (!L.Cycle(Done, Visit)) return;
+                Load();
+            }
+        }
+    }
+#else
+    // Emulated lanes lose to the scalar loop, whose ctz takes all the halvings at once
+    constexpr size_t LaneWidth = 1;
+#endif
+
+    // Calls Visit(Start, C(Start)) for every start in [Begin, End), in no particular order, LaneWidth trajectories
+    // at a time with AVX-512 or AVX2 when the compiler targets them
+    template<typename Fn>
+    static void CMany(uint64_t Begin, uint64_t End, Fn&& Visit) {
+        if (Begin == 0) throw std::runtime_error("Collatz trajectory of zero");
+
+        if constexpr (LaneWidth == 1) {
+            for (uint64_t Start = Begin; Start < End; ++Start) Visit(Start, C(Start));
+        } else {
+            Lanes<LaneWidth> L;
+            L.Next = Begin;
+            L.End = End;
+            for (size_t Lane = 0; Lane < LaneWidth; ++Lane) {
+                if (!L.Refill(Lane, Visit)) break;
+            }
+            if (L.Live[LaneWidth - 1]) RunLanes(L, Visit);
+
+            for (size_t Lane = 0; Lane < LaneWidth; ++Lane) {
+                if (L.Live[Lane]) L.Finish(Lane, Visit);
+            }
+        }
+    }
+
+    // Terras' block map: the low K bits of x alone decide the next K halvings and the m odd steps among them, so
+    // x = h * 2^K + l goes to h * 3^m + r with (m, r) looked up by l
+    // Entries are one word each, r << 6 | Ends << 5 | m, so K = 16 fits in L2, K = 20 in a typical L3 and K = 24 takes
+    // 128MB, Ends marking the l whose own trajectory reaches 1 inside the block
+    class JumpTable {
+        static constexpr uint64_t Ends = 32;
+
+        size_t K;
+        uint64_t Mask;
+        std::vector<uint64_t> Entries;
+        std::array<uint64_t, 64> Pow3 {};
+        // Largest h for which h * 3^m + r can't overflow, for every r in the table with that m
+        std::array<uint64_t, 64> Limit {};
+
+    public:
+        explicit JumpTable(size_t Bits) : K(Bits), Mask((uint64_t(1) << Bits) - 1) {
+            if (Bits < 1 || Bits > 30) throw std::runtime_error("Jump table width must be between 1 and 30 bits");
+
+            Pow3[0] = 1;
+            for (size_t m = 1; m <= K; ++m) Pow3[m] = Pow3[m - 1] * 3;
+
+            // Widen one bit at a time in place: l and l + 2^j share the first j halvings, which end at r and
+            // r + 3^m respectively, and one more halving step of each gives the entries for j + 1 bits
+            Entries.assign(size_t(1) << K, 0);
+            for (size_t j = 0; j < K; ++j) {
+                const size_t Half = size_t(1) << j;
+                for (size_t l = 0; l < Half; ++l) {
+                    const uint64_t m = Entries[l] & 31;
+                    const uint64_t r = Entries[l] >> 6;
+                    for (const size_t Index : { l + Half, l }) {
+                        uint64_t Val = Index == l ? r : r + Pow3[m];
+                        uint64_t Odd = Val & 1;
+                        if (Odd) Val = 3 * Val + 1;
+                        Entries[Index] = ((Val >> 1) << 6) | (m + Odd);
+                    }
+                }
+            }
+
+            std::array<uint64_t, 64> MaxResidual {};
+            for (const uint64_t Entry : Entries) {
+                MaxResidual[Entry & 31] = std::max(MaxResidual[Entry & 31], Entry >> 6);
+            }
+
+            // Walk back from 1 over everything fewer than K halvings away, all of which is below 2^K
+            std::vector<std::pair<uint64_t, size_t>> Pending = { { 1, 0 } };
+            while (!Pending.empty()) {
+                const auto [Val, Halvings] = Pending.back();
+                Pending.pop_back();
+                Entries[Val] |= Ends;
+                if (Halvings + 1 < K) Pending.push_back({ Val * 2, Halvings + 1 });
+                if (Val % 6 == 4 && Val != 4) Pending.push_back({ (Val - 1) / 3, Halvings });
+            }
+            for (size_t m = 0; m <= K; ++m) Limit[m] = (UINT64_MAX - MaxResidual[m]) / Pow3[m];
+        }
+
+        size_t Bits() const {
+            return K;
+        }
+        size_t Bytes() const {
+            return Entries.size() * sizeof(uint64_t);
+        }
+
+        // Takes one block of K halvings, false if the trajectory ends inside it or the block would overflow
+        // From 2^K up the trajectory can't reach 1 before the block ends, below that the entry says
+        bool Jump(uint64_t& Val, Result& Res) const {
+            const uint64_t High = Val >> K;
+            const uint64_t Entry = Entries[Val & Mask];
+            if (High == 0 && (Entry & Ends)) return false;
+
+            const uint64_t m = Entry & 31;
+            if (High > Limit[m]) return false;
+
+            Val = High * Pow3[m] + (Entry >> 6);
+            Res.M += m;
+            Res.D += K;
+            return true;
+        }
+    };
+
+    // Same as C, a block of Table.Bits() halvings per lookup while the value is large enough
+    static Result C(uint64_t Val, const JumpTable& Table) {
+        if (Val == 0) throw std::runtime_error("Collatz trajectory of zero");
+
+        Result Res;
+        while (Val != 1) {
+            if (Table.Jump(Val, Res)) continue;
+
+            // Close to 1, or the block would overflow, so a single step, which may itself have to go wide
+            if (Val & 1) {
+                if (Val > (UINT64_MAX - 1) / 3) {
+                    Excursion(Val, Res);
+                    continue;
+                }
+                Val = 3 * Val + 1;
+                Res.M += 1;
+            }
+            const size_t Zeros = std::countr_zero(Val);
+            Val >>= Zeros;
+            Res.D += Zeros;
+        }
+        Res.B = Res.D + 1;
+        return Res;
+    }
+
+    // M and D of the values below Bound whose trajectory has been run, shared by all the workers of a sweep
+    // One relaxed atomic word per value, M << 16 | D, and 0 until known, so racing writers can only store the same word
+    // Below 2^32 neither count comes near 2^16
+    class Memo {
+        std::unique_ptr<std::atomic<uint32_t>[]> Slots;
+        uint64_t Limit;
+
+        std::atomic<uint64_t> TotalHits { 0 };
+        std::atomic<uint64_t> TotalWalked { 0 };
+
+        // Before anything is allocated for it
+        static uint64_t CheckedBound(uint64_t Bound) {
+            if (Bound > (uint64_t(1) << 32)) throw std::runtime_error("Memo bound above 2^32");
+            return Bound;
+        }
+
+    public:
+        // Per worker, added in with Add so the counters aren't shared per trajectory
+        struct Counts {
+            uint64_t Hits = 0; // Trajectories that stopped at a known value
+            uint64_t Walked = 0; // Steps actually taken, the rest came from the memo
+        };
+
+        explicit Memo(uint64_t Bound) : Slots(new std::atomic<uint32_t>[CheckedBound(Bound)]()), Limit(Bound) {}
+
+        uint64_t Bound() const {
+            return Limit;
+        }
+        size_t Bytes() const {
+            return Limit * sizeof(uint32_t);
+        }
+
+        bool Find(uint64_t Val, Result& Res) const {
+            if (Val >= Limit) return false;
+            const uint32_t Word = Slots[Val].load(std::memory_order_relaxed);
+            if (Word == 0) return false;
+            Res.M = Word >> 16;
+            Res.D = Word & 0xFFFF;
+            return true;
+        }
+        void Store(uint64_t Val, size_t M, size_t D) {
+            if (Val < Limit && M < 0x10000 && D < 0x10000) Slots[Val].store(uint32_t(M << 16 | D), std::memory_order_relaxed);
+        }
+
+        void Add(const Counts& Part) {
+            TotalHits.fetch_add(Part.Hits, std::memory_order_relaxed);
+            TotalWalked.fetch_add(Part.Walked, std::memory_order_relaxed);
+        }
+        Counts Total() const {
+            return { TotalHits.load(), TotalWalked.load() };
+        }
+    };
+
+    // Same as C with the table, stopping at the first value below Val whose counts are in Cache, and storing Val's
+    // Only values below the start are looked up: in an ascending sweep the ones above are hardly ever known yet, and
+    // every lookup is a likely cache miss, as is storing the values met on the way, which was measured to gain nothing
+    static Result C(uint64_t Val, const JumpTable& Table, Memo& Cache, Memo::Counts& Tally) {
+        if (Val == 0) throw std::runtime_error("Collatz trajectory of zero");
+
+        const uint64_t Start = Val;
+        Result Res;
+        Result Known;
+        bool Hit = false;
+        while (Val != 1) {
+            if (Val < Start && Cache.Find(Val, Known)) {
+                Hit = true;
+                break;
+            }
+            if (Table.Jump(Val, Res)) continue;
+
+            if (Val & 1) {
+                if (Val > (UINT64_MAX - 1) / 3) {
+                    Excursion(Val, Res);
+                    continue;
+                }
+                Val = 3 * Val + 1;
+                Res.M += 1;
+            }
+            const size_t Zeros = std::countr_zero(Val);
+            Val >>= Zeros;
+            Res.D += Zeros;
+        }
+
+        Tally.Hits += Hit;
+        Tally.Walked += Res.M + Res.D;
+        Res.M += Known.M;
+        Res.D += Known.D;
+        Cache.Store(Start, Res.M, Res.D);
+        Res.B = Res.D + 1;
+        return Res;
+    }
+
+    // Steps until the trajectory first drops below Start, with B as in C, for Start = 1 there are none
+    static Result Glide(uint64_t Start) {
+        if (Start == 0) throw std::runtime_error("Collatz trajectory of zero");
+
+        Result Res;
+        uint64_t Val = Start;
+        while (Val >= Start && Start != 1) {
+            if (Val & 1) {
+                // Past 64 bits nothing is below Start, so the rare wide stretch can go one plain step at a time
+                if (Val > (UINT64_MAX - 1) / 3) {
+                    const I Floor(Start);
+                    I Big(Val);
+                    while (Big >= Floor) {
+                        if (Big.GetBit(0)) {
+                            Big = Big * I(3) + I(1);
+                            Res.M += 1;
+                        } else {
+                            Big.ApplyShiftRight(1);
+                            Res.D += 1;
+                        }
+                    }
+                    Val = ToWord(Big);
+                    break;
+                }
+                Val = 3 * Val + 1;
+                Res.M += 1;
+            }
+
+            // Only the halvings up to the first value below Start count
+            size_t Zeros = std::countr_zero(Val);
+            if ((Val >> Zeros) < Start) {
+                Zeros = 1;
+                while ((Val >> Zeros) >= Start) ++Zeros;
+            }
+            Val >>= Zeros;
+            Res.D += Zeros;
+        }
+
+        // TopBitIndex + D never decreases along the way
+        Res.B = Res.D + std::bit_width(Val);
+        return Res;
+    }
+
+    // The residues l mod 2^K for which some start h * 2^K + l, h >= 1, isn't certain to drop below itself within K
+    // halvings, in increasing order
+    // After j halvings a start x = h * 2^j + l is at h * 3^m + r, which is below x for every h >= 1 once
+    // 3^m + r < 2^j + l, so a class is settled by its first j bits and the ones that never settle are kept
+    // The same test at h = 0 can fail for the start l itself, those few starts below 2^K are kept as exceptions
+    // Survivors are stored as varint gaps, with every BlockSize-th one marked so blocks can be decoded independently
+    class Sieve {
+        struct Mark {
+            uint64_t Residue;
+            size_t Offset;
+        };
+
+        struct State {
+            uint64_t Residue;
+            uint64_t Pow3;
+            uint64_t Rest;
+        };
+
+        size_t K;
+        uint64_t Count = 0;
+        std::vector<uint8_t> Gaps;
+        std::vector<Mark> Marks;
+        std::vector<uint64_t> Exceptions;
+        uint64_t Last = 0;
+
+        // One more halving of a state at depth Depth, with the start's bit Depth set to Bit
+        // Returns false if the new class drops
+        bool Extend(State& S, size_t Depth, uint64_t Bit) {
+            S.Residue |= Bit << Depth;
+            uint64_t Val = S.Rest + Bit * S.Pow3;
+            if (Val & 1) {
+                Val = 3 * Val + 1;
+                S.Pow3 *= 3;
+            }
+            S.Rest = Val >> 1;
+
+            const uint64_t Scale = uint64_t(1) << (Depth + 1);
+            if (S.Pow3 >= Scale || S.Pow3 + S.Rest >= Scale + S.Residue) return true;
+
+            if (S.Rest >= S.Residue && S.Residue != 0) Exceptions.push_back(S.Residue);
+            return false;
+        }
+
+        void Push(uint64_t Residue) {
+            if (Count % BlockSize == 0) {
+                Marks.push_back({ Residue, Gaps.size() });
+            } else {
+                for (uint64_t Gap = Residue - Last; ; Gap >>= 7) {
+                    Gaps.push_back(static_cast<uint8_t>(Gap & 0x7F) | (Gap >= 0x80 ? 0x80 : 0));
+                    if (Gap < 0x80) break;
+                }
+            }
+            Last = Residue;
+            ++Count;
+        }
+
+    public:
+        static constexpr size_t BlockSize = 4096;
+
+        // Low bits depth first, which comes out unordered but is small, then the high bits of each sorted low class
+        // depth first again, marked in a bitmap that is read back in order
+        explicit Sieve(size_t Bits) : K(Bits) {
+            if (Bits < 1 || Bits > 32) throw std::runtime_error("Sieve width must be between 1 and 32 bits");
+
+            const size_t Low = std::min<size_t>(K, 16);
+            std::vector<State> Classes;
+            std::vector<std::pair<State, size_t>> Pending = { { { 0, 1, 0 }, 0 } };
+            while (!Pending.empty()) {
+                const auto [S, Depth] = Pending.back();
+                Pending.pop_back();
+                if (Depth == Low) {
+                    Classes.push_back(S);
+                    continue;
+                }
+                for (const uint64_t Bit : { 0, 1 }) {
+                    State Next = S;
+                    if (Extend(Next, Depth, Bit)) Pending.push_back({ Next, Depth + 1 });
+                }
+            }
+            std::sort(Classes.begin(), Classes.end(), [](const State& A, const State& B) { return A.Residue < B.Residue; });
+
+            // One row of high bits per low class, so each class's search writes close together, then read off a
+            // column of 64 high values at a time, by high bits then class, which is increasing order
+            const uint64_t Highs = uint64_t(1) << (K - Low);
+            const uint64_t Words = (Highs + 63) / 64;
+            std::vector<uint64_t> Keep(Classes.size() * Words, 0);
+            for (size_t Index = 0; Index < Classes.size(); ++Index) {
+                Pending = { { Classes[Index], Low } };
+                while (!Pending.empty()) {
+                    const auto [S, Depth] = Pending.back();
+                    Pending.pop_back();
+                    if (Depth == K) {
+                        const uint64_t High = S.Residue >> Low;
+                        Keep[Index * Words + High / 64] |= uint64_t(1) << (High % 64);
+                        continue;
+                    }
+                    for (const uint64_t Bit : { 0, 1 }) {
+                        State Next = S;
+                        if (Extend(Next, Depth, Bit)) Pending.push_back({ Next, Depth + 1 });
+                    }
+                }
+            }
+
+            std::vector<uint64_t> Column(Classes.size());
+            for (uint64_t Word = 0; Word < Words; ++Word) {
+                for (size_t Index = 0; Index < Classes.size(); ++Index) Column[Index] = Keep[Index * Words + Word];
+                for (uint64_t Bit = 0; Bit < std::min<uint64_t>(64, Highs); ++Bit) {
+                    for (size_t Index = 0; Index < Classes.size(); ++Index) {
+                        if ((Column[Index] >> Bit) & 1) Push(((Word * 64 + Bit) << Low) | Classes[Index].Residue);
+                    }
+                }
+            }
+
+            std::sort(Exceptions.begin(), Exceptions.end());
+            Exceptions.erase(std::unique(Exceptions.begin(), Exceptions.end()), Exceptions.end());
+        }
+
+        size_t Bits() const {
+            return K;
+        }
+        uint64_t Size() const {
+            return Count;
+        }
+        size_t Bytes() const {
+            return Gaps.size() + Marks.size() * sizeof(Mark) + Exceptions.size() * sizeof(uint64_t);
+        }
+        const std::vector<uint64_t>& Extra() const {
+            return Exceptions;
+        }
+
+        size_t Blocks() const {
+            return Marks.size();
+        }
+        // The first residue of the block, 2^K past the last one
+        uint64_t BlockResidue(size_t Block) const {
+            return Block < Marks.size() ? Marks[Block].Residue : uint64_t(1) << K;
+        }
+        template<typename Fn>
+        void ForEachInBlock(size_t Block, Fn&& Visit) const {
+            uint64_t Residue = Marks[Block].Residue;
+            const uint8_t* In = Gaps.data() + Marks[Block].Offset;
+            const uint64_t Size = std::min<uint64_t>(BlockSize, Count - Block * BlockSize);
+
+            Visit(Residue);
+            for (uint64_t i = 1; i < Size; ++i) {
+                uint64_t Gap = 0;
+                for (size_t Shift = 0; ; Shift += 7) {
+                    const uint8_t Byte = *In++;
+                    Gap |= uint64_t(Byte & 0x7F) << Shift;
+                    if (!(Byte & 0x80)) break;
+                }
+                Residue += Gap;
+                Visit(Residue);
+            }
+        }
+    };
+
+    // Largest value of one quantity over a sweep, and the first start that reached it
+    struct Record {
+        uint64_t Value = 0;
+        uint64_t Start = 0;
+
+        // Offers come in increasing order of start, so a tie keeps the holder it has
+        void Offer(uint64_t Candidate, uint64_t From) {
+            if (Start == 0 || Candidate > Value) {
+                Value = Candidate;
+                Start = From;
+            }
+        }
+    };
+
+    // Totals over the starts [Begin, Next) of a sweep of [Begin, End)
+    // With a sieve, only the starts it keeps are checked and every Result covers the glide alone
+    struct SweepResult {
+        uint64_t Begin = 0;
+        uint64_t End = 0;
+        uint64_t Next = 0;
+        size_t SieveBits = 0; // 0 for a plain sweep
+        uint64_t Checked = 0;
+        uint64_t Steps = 0; // Sum of M + D
+
+        Record M;
+        Record D;
+        Record B;
+        Record C; // M + D, the total stopping time
+
+        void Add(uint64_t Start, const Result& Res) {
+            Checked += 1;
+            Steps += Res.M + Res.D;
+            M.Offer(Res.M, Start);
+            D.Offer(Res.D, Start);
+            B.Offer(Res.B, Start);
+            C.Offer(Res.M + Res.D, Start);
+        }
+
+        // Other must continue where this stopped
+        void Append(const SweepResult& Other) {
+            Checked += Other.Checked;
+            Steps += Other.Steps;
+            for (auto [Own, Theirs] : { std::pair(&M, &Other.M), std::pair(&D, &Other.D), std::pair(&B, &Other.B), std::pair(&C, &Other.C) }) {
+                if (Theirs->Start != 0) Own->Offer(Theirs->Value, Theirs->Start);
+            }
+            Next = Other.Next;
+        }
+
+        // Written to a temporary beside Path and renamed over it, so a kill leaves either the old or the new file
+        void Save(const std::string& Path) const {
+            const std::string Temporary = Path + ".tmp";
+            {
+                std::ofstream Out(Temporary, std::ios::trunc);
+                Out << "CzSweep 2\n" << Begin << " " << End << " " << Next << " " << SieveBits << " " << Checked << " " << Steps << "\n";
+                for (const Record* Rec : { &M, &D, &B, &C }) Out << Rec->Value << " " << Rec->Start << "\n";
+                Out.flush();
+                if (!Out) throw std::runtime_error("Can't write checkpoint " + Temporary);
+            }
+            std::filesystem::rename(Temporary, Path);
+        }
+
+        static std::optional<SweepResult> Load(const std::string& Path) {
+            std::ifstream In(Path);
+            if (!In) return std::nullopt;
+
+            std::string Magic;
+            int Version = 0;
+            SweepResult Res;
+            In >> Magic >> Version >> Res.Begin >> Res.End >> Res.Next >> Res.SieveBits >> Res.Checked >> Res.Steps;
+            for (Record* Rec : { &Res.M, &Res.D, &Res.B, &Res.C }) In >> Rec->Value >> Rec->Start;
+            if (!In || Magic != "CzSweep" || Version != 2) throw std::runtime_error("Malformed checkpoint " + Path);
+            return Res;
+        }
+    };
+
+    // Runs C over every start in [Begin, End) and keeps the largest M, D, B and M + D with the first start reaching each
+    // Workers pull fixed chunks off a shared counter, finished chunks are folded in order of their starts so the result
+    // doesn't depend on the timing, and the folded prefix is what gets checkpointed to CheckpointPath, if given
+    // Given a checkpoint for the same range, the sweep picks up at its first unfinished start
+    // With Residues, it runs Glide on the starts the sieve keeps instead, one chunk per sieve block and period of 2^K,
+    // all the others are already known to drop
+    // Without, Cache, if given, is where trajectories stop once they meet a value whose counts are known
+    static SweepResult Sweep(uint64_t Begin, uint64_t End, size_t Threads, const std::string& CheckpointPath = "", const Sieve* Residues = nullptr,
+        Memo* Cache = nullptr) {
+        static constexpr uint64_t ChunkSize = uint64_t(1) << 16;
+        static constexpr auto CheckpointInterval = std::chrono::seconds(10);
+
+        if (Begin == 0) throw std::runtime_error("Collatz sweep can't start at zero");
+
+        SweepResult Res;
+        Res.Begin = Begin;
+        Res.End = std::max(Begin, End);
+        Res.Next = Begin;
+        Res.SieveBits = Residues ? Residues->Bits() : 0;
+        if (!CheckpointPath.empty()) {
+            if (auto Saved = SweepResult::Load(CheckpointPath)) {
+                if (Saved->Begin != Res.Begin || Saved->End != Res.End || Saved->SieveBits != Res.SieveBits) {
+                    throw std::runtime_error("Checkpoint " + CheckpointPath + " is for another sweep");
+                }
+                Res = *Saved;
+            }
+        }
+        const uint64_t From = Res.Next;
+        if (From >= Res.End) return Res;
+
+        // Chunk Index covers the starts [Bounds(Index).first, Bounds(Index).second) of the remaining range
+        uint64_t FirstChunk = 0;
+        uint64_t Chunks = 0;
+        std::function<std::pair<uint64_t, uint64_t>(uint64_t)> Bounds;
+        if (Residues) {
+            const size_t K = Residues->Bits();
+            const uint64_t Blocks = Residues->Blocks();
+            const uint64_t FirstPeriod = Begin >> K;
+            Bounds = [=, End = Res.End](uint64_t Index) {
+                const uint64_t Base = (FirstPeriod + Index / Blocks) << K;
+                const uint64_t Block = Index % Blocks;
+                // Block 0 also takes the exceptions at the start of the period, the first and last period are partial
+                const uint64_t Low = Block == 0 ? Base : Base + Residues->BlockResidue(Block);
+                const uint64_t High = Base + std::min(End - Base, Residues->BlockResidue(Block + 1));
+                return std::pair(std::clamp(Low, Begin, End), std::clamp(High, Begin, End));
+            };
+            Chunks = ((((Res.End - 1) >> K) - FirstPeriod + 1) * Blocks);
+            while (FirstChunk < Chunks && Bounds(FirstChunk).second <= From) ++FirstChunk;
+        } else {
+            Bounds = [From, End = Res.End](uint64_t Index) {
+                const uint64_t Low = From + Index * ChunkSize;
+                return std::pair(Low, std::min(End, Low + ChunkSize));
+            };
+            Chunks = (Res.End - From + ChunkSize - 1) / ChunkSize;
+        }
+
+        const std::optional<JumpTable> Table = Residues ? std::nullopt : std::optional<JumpTable>(16);
+
+        std::atomic<uint64_t> NextChunk { FirstChunk };
+        std::mutex FoldLock;
+        std::map<uint64_t, SweepResult> Finished;
+        uint64_t Folded = FirstChunk;
+        auto LastSave = std::chrono::steady_clock::now();
+
+        auto Work = [&] {
+            std::vector<uint64_t> Starts;
+            while (true) {
+                const uint64_t Index = NextChunk.fetch_add(1);
+                if (Index >= Chunks) return;
+
+                const auto [Low, High] = Bounds(Index);
+                SweepResult Part;
+                Part.Next = High;
+                if (Residues) {
+                    const size_t K = Residues->Bits();
+                    const uint64_t Base = (Low >> K) << K;
+                    Starts.clear();
+                    if (Base == 0) {
+                        for (uint64_t Start : Residues->Extra()) {
+                            if (Start >= Low && Start < High) Starts.push_back(Start);
+                        }
+                    }
+                    Residues->ForEachInBlock(Index % Residues->Blocks(), [&](uint64_t Residue) {
+                        const uint64_t Start = Base + Residue;
+                        if (Start >= Low && Start < High) Starts.push_back(Start);
+                    });
+                    if (Base == 0) std::sort(Starts.begin(), Starts.end());
+
+                    for (uint64_t Start : Starts) Part.Add(Start, Glide(Start));
+                } else if (Cache) {
+                    Memo::Counts Tally;
+                    for (uint64_t Start = Low; Start < High; ++Start) Part.Add(Start, C(Start, *Table, *Cache, Tally));
+                    Cache->Add(Tally);
+                } else {
+                    for (uint64_t Start = Low; Start < High; ++Start) Part.Add(Start, C(Start, *Table));
+                }
+
+                std::lock_guard Lock(FoldLock);
+                Finished.emplace(Index, Part);
+                while (!Finished.empty() && Finished.begin()->first == Folded) {
+                    Res.Append(Finished.begin()->second);
+                    Finished.erase(Finished.begin());
+                    ++Folded;
+                }
+                if (!CheckpointPath.empty() && std::chrono::steady_clock::now() - LastSave >= CheckpointInterval) {
+                    Res.Save(CheckpointPath);
+                    LastSave = std::chrono::steady_clock::now();
+                }
+            }
+        };
+
+        {
+            WorkPool Pool(Threads);
+            WorkPool::Group All;
+            for (size_t i = 0; i < Pool.Size(); ++i) Pool.Submit(All, Work);
+            Pool.Wait(All);
+        }
+
+        if (!CheckpointPath.empty()) Res.Save(CheckpointPath);
+        return Res;
+    }
+
     void PrintStepsInfo(I Val) {
         Result Res = C(Val);
         std::cout
@@ -201,59 +1122,124 @@ namespace Cz {
     }
 };
 
+// A value too wide for the word engine, split so the steps only touch a few bits of it: x = 3^Q * High * 2^E + Low
+// Low is exact and carries what the steps add on top of High, so 3x + 1 and x / 2 are O(1) on (Low, E, Q), and High
+// is brought up to date in one multiply-add pass once E runs out or 3^Q fills a word, roughly every 50 steps rather
+// than once per multiply step
 struct MutliCollatz {
-    struct Entry {
-        Cz::I BaseValue = 1;
+    // 3^20 < 2^32, so the pending multiplier stays a single word
+    static constexpr size_t MaxPending = 20;
+    static constexpr size_t WindowBits = 32;
 
-        size_t Exponentiations = 0;
+    std::vector<uint32_t> High;
+    uint64_t Low = 0;
+    size_t E = 0;
+    size_t Q = 0;
+    uint32_t Pow3 = 1;
+    Cz::Result Steps;
 
-        // This will be updated lazily when applying
-        size_t Shift = 0;
+    // High = High * 3^Q + Low / 2^E, keeping Low mod 2^E, and when E is 0 the lowest word of High moves into Low
+    // Low < 3^Q * 2^E + 3^Q / 2 with E <= 32, so the carry in is below 2^33 and every word of the pass fits in 64 bits
+    void Renormalize() {
+        uint64_t Carry = Low >> E;
+        Low = E == 0 ? 0 : Low & ((uint64_t(1) << E) - 1);
 
-        // How many rightward shifts the parent had at the time of last update
-        size_t LastUpdatedNumShifts = 0;
-    };
+        // With E = 0 the first word out is the new window, and the rest are written one behind where they are read
+        const bool Refill = E == 0;
+        bool Taken = false;
+        size_t Out = 0;
+        auto Emit = [&](uint32_t Word) {
+            if (Refill && !Taken) {
+                Low = Word;
+                Taken = true;
+            } else if (Out < High.size()) {
+                High[Out++] = Word;
+            } else {
+                High.push_back(Word);
+                ++Out;
+            }
+        };
+        for (size_t i = 0; i < High.size(); ++i) {
+            const uint64_t Word = uint64_t(High[i]) * Pow3 + Carry;
+            Carry = Word >> 32;
+            Emit(static_cast<uint32_t>(Word));
+        }
+        for (; Carry != 0; Carry >>= 32) Emit(static_cast<uint32_t>(Carry));
+        High.resize(Out);
+        while (!High.empty() && High.back() == 0) High.pop_back();
 
-    std::vector<Entry> Entries;
+        if (Refill) E = WindowBits;
+        Q = 0;
+        Pow3 = 1;
+    }
 
+    // One step, 3x + 1 if x is odd and x / 2 otherwise
     void Apply() {
+        if (E == 0 || ((Low & 1) && Q == MaxPending)) Renormalize();
 
-    }
-
-    static MutliCollatz From(Cz::I Val) {
-        if (Val.IsZero()) {
-            throw std::runtime_error("Cannot create MultiCollatz from zero");
+        if (Low & 1) {
+            Low = 3 * Low + 1;
+            Pow3 *= 3;
+            ++Q;
+            ++Steps.M;
+        } else {
+            Low >>= 1;
+            --E;
+            ++Steps.D;
         }
+    }
 
-        MutliCollatz Res;
-
-        const size_t TopBit = Val.TopBitIndex();
-
-        std::optional<size_t> Started;
-        std::optional<size_t> LastBit;
+    // Steps until x fits in a word, which it does once High is gone, and returns x
+    uint64_t RunWide() {
+        while (!High.empty()) {
+            // High may be gone afterwards, and then x = Low has to go through the check again
+            if (E == 0 || ((Low & 1) && Q == MaxPending)) {
+                Renormalize();
+                continue;
+            }
 
-        for (size_t i = 0; i <= TopBit + 1; ++i) {
-            if (Started.has_value()) {
-                if (Val.GetBit(i)) {
-                    LastBit = i;
-                } else if (i == (*LastBit + 2) || i > TopBit) {
-                    //std::cout << "Entry from bit " << *Started << ", length " << (*LastBit - *Started + 1) << "\n";
+            if (Low & 1) {
+                Low = 3 * Low + 1;
+                Pow3 *= 3;
+                ++Q;
+                ++Steps.M;
+            }
+            // All the halvings the window can see at once
+            const size_t Zeros = std::min<size_t>(std::countr_zero(Low), E);
+            Low >>= Zeros;
+            E -= Zeros;
+            Steps.D += Zeros;
+        }
+        return Low;
+    }
 
-                    Res.Entries.emplace_back(
-                        Cz::I::Pow(Cz::I(2), *Started),
-                        *Started,
-                        *LastBit - *Started + 1
-                    );
+    Cz::I Value() const {
+        Cz::I Res;
+        for (size_t i = 0; i < High.size(); ++i) Res[i] = High[i];
+        Res = Res * Cz::I(Pow3);
+        Res <<= E;
+        return Res + Cz::I(Low);
+    }
 
-                    Started.reset();
-                    LastBit.reset();
-                }
-            } else if (Val.GetBit(i)) {
-                Started = i;
-                LastBit = i;
-            }
+    static MutliCollatz From(const Cz::I& Val) {
+        if (Val.Sign() <= 0) {
+            throw std::runtime_error("Cannot create MultiCollatz from a non-positive value");
         }
 
-        return {};
+        MutliCollatz Res;
+        Res.High.resize(Val.Size());
+        for (size_t i = 0; i < Val.Size(); ++i) Res.High[i] = Val[i];
+        // E = 0 has the first step pull the lowest word into the window
+        return Res;
+    }
+
+    // Same as Cz::C, for values of millions of bits
+    static Cz::Result C(const Cz::I& Val) {
+        MutliCollatz Lazy = From(Val);
+        uint64_t Rest = Lazy.RunWide();
+        Cz::Result Res = Lazy.Steps;
+        Cz::RunFrom(Rest, Res);
+        Res.B = Res.D + 1;
+        return Res;
     }
-};
\ No newline at end of file
+};
@@ -2,8 +2,30 @@
 
 #include "rational.hpp"
 
+#include <tuple>
+
 template<typename T = Rational<>>
 class Complex {
+    static constexpr bool FractionFree = requires(const T& Val) {
+        T(Val.Numerator(), Val.Denominator());
+    };
+
+    // Real = RealNum / Den and Imag = ImagNum / Den with Den the least common denominator
+    auto ToIntegers() const requires FractionFree {
+        const auto RealDen = Real.Denominator();
+        const auto ImagDen = Imag.Denominator();
+        const auto Den = RealDen == ImagDen ? RealDen : RealDen / decltype(RealDen)::GCD(RealDen, ImagDen) * ImagDen;
+        return std::make_tuple(Real.Numerator() * (Den / RealDen), Imag.Numerator() * (Den / ImagDen), Den);
+    }
+
+    template<typename V>
+    static std::pair<V, V> MulParts(const V& A, const V& B, const V& C, const V& D) {
+        const V K1 = C * (A + B);
+        const V K2 = A * (D - C);
+        const V K3 = B * (C + D);
+        return { K1 - K3, K1 + K2 };
+    }
+
 public:
     T Real;
     T Imag;
@@ -32,34 +54,55 @@ public:
         Real.ApplyNegate();
         Imag.ApplyNegate();
     }
+    // L1 norm |Re| + |Im| as a real value, zero exactly when the value is and within a factor √2 of the modulus
+    // Rational has no square roots, and this is all Polynomial needs for its bounds
+    void ApplyAbs() {
+        Real.ApplyAbs();
+        Imag.ApplyAbs();
+        Real += Imag;
+        Imag = T(0);
+    }
+    void ApplyConjugate() {
+        Imag.ApplyNegate();
+    }
 
     // Serde
+    // Values with both parts are parenthesized, so they read as one value inside sums such as polynomial terms
     static std::string ToString(Complex Val, int64_t MaxDigits = 10) {
-        if (Val.Real.IsZero() && Val.Imag.IsZero()) {
-            return "0";
+        auto PartToString = [MaxDigits](const T& Part) {
+            if constexpr (requires { T::ToString(Part, MaxDigits); }) {
+                return T::ToString(Part, MaxDigits);
+            } else {
+                return T::ToString(Part);
+            }
+        };
+
+        if (Val.Imag.IsZero()) {
+            return PartToString(Val.Real);
         }
+
+        const bool Negative = Val.Imag < 0;
+        T Magnitude = Val.Imag;
+        Magnitude.ApplyAbs();
+        const std::string ImagStr = Magnitude == T(1) ? "i" : PartToString(Magnitude) + "i";
+
         if (Val.Real.IsZero()) {
-            return T::ToString(Val.Imag) + "i";
-        } else {
-            return T::ToString(Val.Real);
+            return Negative ? "-" + ImagStr : ImagStr;
         }
+        return "(" + PartToString(Val.Real) + (Negative ? " - " : " + ") + ImagStr + ")";
     }
 
     static Complex Pow(Complex LHS, size_t RHS) {
-        Complex Result;
-        Result.Real = T { 1 };
-        Result.Imag = T { 0 };
+        Complex Result = MakeReal(T { 1 });
 
         while (RHS > 0) {
             if (RHS % 2 == 1) {
-                T RealTemp = Result.Real * LHS.Real - Result.Imag * LHS.Imag;
-                Result.Imag = Result.Real * LHS.Imag + Result.Imag * LHS.Real;
-                Result.Real = RealTemp;
+                Result *= LHS;
             }
-            T RealTemp = LHS.Real * LHS.Real - LHS.Imag * LHS.Imag;
-            LHS.Imag = T(2) * LHS.Real * LHS.Imag;
-            LHS.Real = RealTemp;
             RHS /= 2;
+            if (RHS > 0) {
+                LHS *= LHS;
+            }
         }
 
         return Result;
@@ -93,24 +136,49 @@ public:
         Other.Imag = Imag - Other.Imag;
         return Other;
     }
+    // Gauss' trick, three real products instead of four:
+    // (a + bi)(c + di) = (k1 - k3) + (k1 + k2)i with k1 = c(a + b), k2 = a(d - c), k3 = b(c + d)
+    // Fractions are multiplied as integers over a common denominator, so each part is reduced only once
     Complex& operator*=(const Complex& Other) {
-        T TmpReal = Real;
-        Real = Real * Other.Real - Imag * Other.Imag;
-        Imag = TmpReal * Other.Imag + Imag * Other.Real;
+        if constexpr (FractionFree) {
+            auto [LReal, LImag, LDen] = ToIntegers();
+            auto [RReal, RImag, RDen] = Other.ToIntegers();
+            auto [ResReal, ResImag] = MulParts(LReal, LImag, RReal, RImag);
+
+            const auto Den = LDen * RDen;
+            Real = T(ResReal, Den);
+            Imag = T(ResImag, Den);
+        } else {
+            auto [ResReal, ResImag] = MulParts(Real, Imag, Other.Real, Other.Imag);
+            Real = std::move(ResReal);
+            Imag = std::move(ResImag);
+        }
         return *this;
     }
     Complex operator*(Complex Other) const {
         Other *= *this;
         return Other;
     }
-    Complex& operator /=(const Complex& Other) {
-        // TODO could be more efficient
-        T Den = Other.Real * Other.Real + Other.Imag * Other.Imag;
-        Den.ApplyReciprocal();
-        Complex C;
-        C.Real = (Real * Other.Real + Imag * Other.Imag) * Den;
-        C.Imag = (Imag * Other.Real - Real * Other.Imag) * Den;
-        *this = C;
+    // (a + bi) / (c + di) = (a + bi)(c - di) / (c^2 + d^2)
+    // Fractions are taken over integers, so the quotient is one product and one reduction per part
+    Complex& operator/=(const Complex& Other) {
+        if (Other.IsZero()) throw std::runtime_error("Attempting division by zero complex");
+
+        if constexpr (FractionFree) {
+            auto [LReal, LImag, LDen] = ToIntegers();
+            auto [RReal, RImag, RDen] = Other.ToIntegers();
+            auto [ResReal, ResImag] = MulParts(LReal, LImag, RReal, -RImag);
+
+            // (L / LDen) / (R / RDen) = L * conj(R) * RDen / (LDen * |R|^2)
+            const auto Den = LDen * (RReal * RReal + RImag * RImag);
+            Real = T(ResReal * RDen, Den);
+            Imag = T(ResImag * RDen, Den);
+        } else {
+            const T Den = Other.Real * Other.Real + Other.Imag * Other.Imag;
+            auto [ResReal, ResImag] = MulParts(Real, Imag, Other.Real, -Other.Imag);
+            Real = ResReal / Den;
+            Imag = ResImag / Den;
+        }
         return *this;
     }
     Complex operator/(const Complex& Other) const {
@@ -120,4 +188,10 @@ public:
     }
     bool operator==(const Complex& Other) const { return Real == Other.Real && Imag == Other.Imag; }
     bool operator!=(const Complex& Other) const { return !(*this == Other); }
-};
\ No newline at end of file
+    // Lexicographic on (Real, Imag), not compatible with arithmetic but a total order, so values can key maps and
+    // the sign of a polynomial coefficient is the sign of its first nonzero part
+    bool operator<(const Complex& Other) const { return Real < Other.Real || (Real == Other.Real && Imag < Other.Imag); }
+    bool operator>(const Complex& Other) const { return Other < *this; }
+    bool operator<=(const Complex& Other) const { return !(Other < *this); }
+    bool operator>=(const Complex& Other) const { return !(*this < Other); }
+};
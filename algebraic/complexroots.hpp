@@ -0,0 +1,382 @@
+#pragma once
+
+#include "polynomial.hpp"
+#include "complex.hpp"
+
+#include <map>
+#include <memory>
+#include <optional>
+
+// Counts and isolates the complex roots of a real polynomial in axis-aligned boxes, by the argument principle
+// On an edge P = U + iV with U, V real polynomials in the edge coordinate. Going once around a box the argument
+// of P turns by 2π per enclosed root, and every turn crosses U = 0 twice, so the number of roots is minus half the
+// sum of the Cauchy indices of V / U along the four edges. Each index comes from a Sturm-like remainder chain of
+// U and V, so everything is exact. The restriction of P to every line is kept, quadtree neighbours share edges
+template<typename T = Rational<>>
+class ComplexRoots {
+public:
+    using Poly = Polynomial<T>;
+    using Z = Complex<T>;
+
+    // Closed box [Lo.Real, Hi.Real] x [Lo.Imag, Hi.Imag]
+    struct Box {
+        Z Lo;
+        Z Hi;
+
+        Z Center() const {
+            return Z((Lo.Real + Hi.Real) / 2, (Lo.Imag + Hi.Imag) / 2);
+        }
+    };
+
+private:
+    // Remainder chain of Re and Im of (1 + ki)P along a line, and the Sturm sequence of their GCD if it isn't constant
+    // Both go through SturmEvaluator, so most signs are settled in floating point and endpoints shared between boxes
+    // are evaluated once
+    struct Chain {
+        std::shared_ptr<const typename Poly::SturmEvaluator> Links;
+        std::shared_ptr<const typename Poly::SturmEvaluator> Common;
+    };
+
+    // P restricted to a horizontal or vertical line, as a function of the coordinate along it
+    // Every box edge on the line reuses its chains, only the endpoints change
+    struct Line {
+        Poly U;
+        Poly V;
+        std::map<int64_t, Chain> Chains;
+
+        const Chain& GetChain(int64_t K) {
+            auto It = Chains.find(K);
+            if (It != Chains.end()) return It->second;
+
+            std::vector<Poly> Links;
+            Links.push_back(K == 0 ? U : U - V * Poly(T(K), 0));
+            Links.push_back(K == 0 ? V : V + U * Poly(T(K), 0));
+            while (!Links.back().IsZero()) {
+                Links.push_back(-(*(Links.rbegin() + 1) % Links.back()));
+            }
+            Links.pop_back();
+
+            // The last link is the GCD
+            Chain Res;
+            if (Links.back().Degree() > 0) {
+                Res.Common = std::make_shared<const typename Poly::SturmEvaluator>(Poly::MakeSturmSequence(Links.back()));
+            }
+            Res.Links = std::make_shared<const typename Poly::SturmEvaluator>(std::move(Links));
+            return Chains.emplace(K, std::move(Res)).first->second;
+        }
+    };
+
+    // Distinct roots matter, not multiplicities
+    Poly Simple;
+    std::shared_ptr<const typename Poly::SturmEvaluator> Real;
+
+    std::map<T, Line> Horizontal;
+    std::map<T, Line> Vertical;
+
+    // P(x + i y), the Taylor expansion around x in powers of i y
+    Line& GetHorizontal(const T& Y) {
+        auto It = Horizontal.find(Y);
+        if (It != Horizontal.end()) return It->second;
+
+        Line Res;
+        Poly Derivative = Simple;
+        T Scale(1);
+        for (uint32_t k = 0; !Derivative.IsZero(); ++k) {
+            // i^k is 1, i, -1, -i in turn
+            const Poly Part = Derivative * Poly((k & 2) ? -Scale : Scale, 0);
+            if (k & 1) {
+                Res.V += Part;
+            } else {
+                Res.U += Part;
+            }
+
+            Derivative.ApplyDerivative(1);
+            Scale = Scale * Y / T(int64_t(k + 1));
+        }
+        return Horizontal.emplace(Y, std::move(Res)).first->second;
+    }
+
+    // P(x + i y) = Q(i y) with Q the shift of P by x
+    Line& GetVertical(const T& X) {
+        auto It = Vertical.find(X);
+        if (It != Vertical.end()) return It->second;
+
+        Line Res;
+        const Poly Shifted = Poly::TaylorShift(Simple, X);
+        for (const auto& t : Shifted.GetTerms()) {
+            const Poly Part((t.Exp & 2) ? -t.Cof : t.Cof, t.Exp);
+            if (t.Exp & 1) {
+                Res.V += Part;
+            } else {
+                Res.U += Part;
+            }
+        }
+        return Vertical.emplace(X, std::move(Res)).first->second;
+    }
+
+    // Cauchy index of Im / Re over [A, B] from their chain, nothing if they share a root there, a root of P on the
+    // edge. Re must not vanish at A or B
+    static std::optional<int32_t> CauchyIndex(const Chain& Edge, const T& A, const T& B) {
+        if (Edge.Common) {
+            bool AIsRoot, BIsRoot;
+            const int32_t Count = Edge.Common->CountSignChanges(A, AIsRoot) - Edge.Common->CountSignChanges(B, BIsRoot);
+            if (Count != 0 || AIsRoot) return std::nullopt;
+        }
+
+        bool Unused;
+        return Edge.Links->CountSignChanges(A, Unused) - Edge.Links->CountSignChanges(B, Unused);
+    }
+
+    // Roots inside the box, nothing if one lies on its boundary
+    std::optional<int32_t> TryCount(const Box& Region) {
+        const T& X0 = Region.Lo.Real;
+        const T& X1 = Region.Hi.Real;
+        const T& Y0 = Region.Lo.Imag;
+        const T& Y1 = Region.Hi.Imag;
+
+        Line& Bottom = GetHorizontal(Y0);
+        Line& Top = GetHorizontal(Y1);
+        Line& Left = GetVertical(X0);
+        Line& Right = GetVertical(X1);
+
+        // P at the corners, a zero there is a root on the boundary
+        const std::pair<T, T> Corners[4] = {
+            { Bottom.U.Evaluate(X0), Bottom.V.Evaluate(X0) }, { Bottom.U.Evaluate(X1), Bottom.V.Evaluate(X1) },
+            { Top.U.Evaluate(X0), Top.V.Evaluate(X0) }, { Top.U.Evaluate(X1), Top.V.Evaluate(X1) },
+        };
+        for (const auto& [Re, Im] : Corners) {
+            if (Re.IsZero() && Im.IsZero()) return std::nullopt;
+        }
+
+        // Counting (1 + ki)P instead leaves the roots alone, and some k keeps its real part off zero at every corner
+        int64_t K = 0;
+        while (true) {
+            bool Clear = true;
+            for (const auto& [Re, Im] : Corners) {
+                if ((Re - T(K) * Im).IsZero()) Clear = false;
+            }
+            if (Clear) break;
+            ++K;
+        }
+
+        // The index is additive over the path, and reversing an edge negates it
+        int32_t Total = 0;
+        auto AddEdge = [&](Line& Edge, const T& From, const T& To) {
+            const bool Forward = From < To;
+            const auto Index = CauchyIndex(Edge.GetChain(K), Forward ? From : To, Forward ? To : From);
+            if (!Index) return false;
+            Total += Forward ? *Index : -*Index;
+            return true;
+        };
+
+        // Counterclockwise
+        if (!AddEdge(Bottom, X0, X1) || !AddEdge(Right, Y0, Y1) || !AddEdge(Top, X1, X0) || !AddEdge(Left, Y1, Y0)) {
+            return std::nullopt;
+        }
+
+        if (Total % 2 != 0 || Total > 0) throw std::runtime_error("Winding number of a box isn't a whole number of turns");
+        return -Total / 2;
+    }
+
+    // Halves the box across its longer side, counting the first half. When the cut would pass through a root it is
+    // moved off the middle, the other half's count is the difference, so every cut costs one count
+    std::pair<std::pair<Box, int32_t>, std::pair<Box, int32_t>> Halve(const Box& Region, int32_t Roots) {
+        const T Width = Region.Hi.Real - Region.Lo.Real;
+        const T Height = Region.Hi.Imag - Region.Lo.Imag;
+        const bool Vertical = Width >= Height;
+        for (int64_t Offset = 0; ; ++Offset) {
+            // 1/2, 1/2 - 1/8, 1/2 + 1/8, 1/2 - 1/16, ...
+            T Fraction = T(1, 2);
+            if (Offset > 0) {
+                const T Shift = T::Pow(T(2), -(Offset + 5) / 2);
+                Fraction = (Offset & 1) ? Fraction - Shift : Fraction + Shift;
+            }
+
+            Box First = Region;
+            Box Second = Region;
+            if (Vertical) {
+                const T Cut = Region.Lo.Real + Width * Fraction;
+                First.Hi.Real = Cut;
+                Second.Lo.Real = Cut;
+            } else {
+                const T Cut = Region.Lo.Imag + Height * Fraction;
+                First.Hi.Imag = Cut;
+                Second.Lo.Imag = Cut;
+            }
+
+            const auto FirstRoots = TryCount(First);
+            if (FirstRoots) return { { First, *FirstRoots }, { Second, Roots - *FirstRoots } };
+        }
+    }
+
+    // One box per distinct root, not yet small
+    std::vector<Box> Separate() {
+        // Every root is strictly inside the Cauchy disk, so none is on this box
+        T Bound = Poly::CauchyBounds(Simple) - 1;
+        Bound.ApplyAbs();
+        Bound = Bound + 1;
+
+        std::vector<std::pair<Box, int32_t>> Pending { { Box { Z(-Bound, -Bound), Z(Bound, Bound) }, int32_t(Simple.Degree()) } };
+        std::vector<Box> Res;
+        while (!Pending.empty()) {
+            auto [Region, Roots] = Pending.back();
+            Pending.pop_back();
+            if (Roots == 0) continue;
+            if (Roots == 1) {
+                Res.push_back(Region);
+                continue;
+            }
+
+            auto [First, Second] = Halve(Region, Roots);
+            Pending.push_back(std::move(Second));
+            Pending.push_back(std::move(First));
+        }
+        return Res;
+    }
+
+    // 2^k with 2^-k at most MaxError / 16
+    static decltype(T().Numerator()) GridScale(const T& MaxError) {
+        using Integer = decltype(T().Numerator());
+        Integer Scale(1);
+        while (T(1, Scale) * 16 > MaxError) Scale = Scale * Integer(2);
+        return Scale;
+    }
+
+    // Newton's method in Q(i) from the center, every iterate rounded to a dyadic grid well below MaxError so the
+    // numbers stay short. Nothing if it wanders off the box or doesn't settle
+    std::optional<Z> Newton(const Box& Region, const T& MaxError) const {
+        const std::vector<T> Cofs = Simple.ToDense();
+
+        auto Round = [Scale = GridScale(MaxError)](const T& Val) {
+            return T((Val * T(Scale)).Round(), Scale);
+        };
+
+        Z Guess = Region.Center();
+        for (uint32_t Step = 0; Step < 64; ++Step) {
+            // P and P' at Guess by Horner
+            Z Val = Z(Cofs.back());
+            Z Slope;
+            for (size_t i = Cofs.size() - 1; i-- > 0;) {
+                Slope = Slope * Guess + Val;
+                Val = Val * Guess + Z(Cofs[i]);
+            }
+            if (Slope.IsZero()) return std::nullopt;
+
+            const Z Delta = Val / Slope;
+            const Z Next(Round(Guess.Real - Delta.Real), Round(Guess.Imag - Delta.Imag));
+            if (Next.Real < Region.Lo.Real || Next.Real > Region.Hi.Real || Next.Imag < Region.Lo.Imag || Next.Imag > Region.Hi.Imag) {
+                return std::nullopt;
+            }
+
+            const bool Settled = Next == Guess;
+            Guess = Next;
+            if (Settled) return Guess;
+        }
+        return std::nullopt;
+    }
+
+    // Rouché's theorem: writing P = Σ a_k (z - c)^k, if |a_0| + Σ_{k>=2} |a_k| r^k < |a_1| r then P has as many roots
+    // in |z - c| < r as a_1 (z - c) does, exactly one. |x + iy| lies between max(|x|, |y|) and |x| + |y|, so the
+    // test stays in T and only errs on the side of failing
+    bool HasOneRootNear(const Z& Center, const T& Radius) const {
+        std::vector<Z> Taylor;
+        for (const T& Cof : Simple.ToDense()) {
+            Taylor.push_back(Z(Cof));
+        }
+
+        // Repeated Horner steps leave the Taylor coefficients at Center
+        for (size_t k = 0; k + 1 < Taylor.size(); ++k) {
+            for (size_t i = Taylor.size() - 1; i-- > k;) {
+                Taylor[i] += Taylor[i + 1] * Center;
+            }
+        }
+
+        auto Abs = [](T Val) {
+            Val.ApplyAbs();
+            return Val;
+        };
+
+        T Rest = Abs(Taylor[0].Real) + Abs(Taylor[0].Imag);
+        T Power = Radius;
+        for (size_t k = 2; k < Taylor.size(); ++k) {
+            Power = Power * Radius;
+            Rest = Rest + (Abs(Taylor[k].Real) + Abs(Taylor[k].Imag)) * Power;
+        }
+        return Rest < std::max(Abs(Taylor[1].Real), Abs(Taylor[1].Imag)) * Radius;
+    }
+
+    // Shrinks the box around its single root to at most MaxError across
+    // A real root is refined on the real line by Sturm sequences and comes back as a box of height 0. Otherwise
+    // Newton's guess is checked by HasOneRootNear, and bisection takes over when that fails
+    Box Refine(Box Region, const T& MaxError) {
+        if (!(Region.Lo.Imag > 0) && !(Region.Hi.Imag < 0)) {
+            bool Unused;
+            if (Real->CountSignChanges(Region.Lo.Real, Unused) != Real->CountSignChanges(Region.Hi.Real, Unused)) {
+                T A = Region.Lo.Real;
+                T B = Region.Hi.Real;
+                if (!Poly::RefineRoot(Simple, A, B, MaxError)) throw std::runtime_error("Isolating interval has no sign change");
+                return Box { Z(A, T(0)), Z(B, T(0)) };
+            }
+        }
+
+        while (Region.Hi.Real - Region.Lo.Real > MaxError || Region.Hi.Imag - Region.Lo.Imag > MaxError) {
+            if (const auto Guess = Newton(Region, MaxError)) {
+                // The disk has a root and the box around it lies in the isolating box, so it is the one root there
+                const T Half = MaxError / 2;
+                const Box Check { Z(Guess->Real - Half, Guess->Imag - Half), Z(Guess->Real + Half, Guess->Imag + Half) };
+                const bool Inside = !(Check.Lo.Real < Region.Lo.Real) && !(Check.Lo.Imag < Region.Lo.Imag) &&
+                    !(Check.Hi.Real > Region.Hi.Real) && !(Check.Hi.Imag > Region.Hi.Imag);
+                if (Inside && HasOneRootNear(*Guess, Half)) return Check;
+            }
+
+            // Two halvings, whichever half holds the root
+            for (uint32_t i = 0; i < 2; ++i) {
+                auto [First, Second] = Halve(Region, 1);
+                Region = First.second == 1 ? First.first : Second.first;
+            }
+        }
+        return Region;
+    }
+
+public:
+    explicit ComplexRoots(const Poly& P) {
+        if (P.IsZero()) throw std::runtime_error("Zero polynomial has no isolated roots");
+        Simple = Poly::SquareFreePart(P);
+        Real = std::make_shared<const typename Poly::SturmEvaluator>(Poly::MakeSturmSequence(Simple));
+    }
+
+    // Distinct roots inside the closed box, throws if one lies on its boundary
+    int32_t Count(const Box& Region) {
+        const auto Res = TryCount(Region);
+        if (!Res) throw std::runtime_error("Root on the boundary of the box");
+        return *Res;
+    }
+
+    // A box per distinct root, each at most MaxWidth wide and tall and holding exactly that root
+    // Real roots get boxes of height 0 on the real line
+    std::vector<Box> Isolate(const T& MaxWidth) {
+        std::vector<Box> Res;
+        for (const Box& Region : Separate()) {
+            Res.push_back(Refine(Region, MaxWidth));
+        }
+        return Res;
+    }
+
+    // Approximations within MaxError of every distinct root, real ones included
+    std::vector<Z> Evaluate(const T& MaxError) {
+        std::vector<Z> Res;
+        for (const Box& Region : Isolate(MaxError)) {
+            Res.push_back(Region.Center());
+        }
+        return Res;
+    }
+
+    // Only the roots off the real line, the ones EvaluateRootsInRange can't see
+    std::vector<Z> EvaluateNonReal(const T& MaxError) {
+        std::vector<Z> Res;
+        for (const Box& Region : Isolate(MaxError)) {
+            if (!Region.Lo.Imag.IsZero() || !Region.Hi.Imag.IsZero()) Res.push_back(Region.Center());
+        }
+        return Res;
+    }
+};
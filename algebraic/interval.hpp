@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <stdint.h>
+
+// Closed interval of floating point values [Lo, Hi]
+// Every operation rounds outward by one ulp, so the exact result of the same operations on any points inside the
+// operands is always contained in the result. Overflow and NaN widen to the whole line instead of lying
+template<typename F = double>
+struct Interval {
+    F Lo = 0;
+    F Hi = 0;
+
+    Interval() = default;
+    Interval(F Val) : Lo(Val), Hi(Val) { }
+    Interval(F InLo, F InHi) : Lo(InLo), Hi(InHi) {
+        if (std::isnan(Lo) || std::isnan(Hi)) *this = Whole();
+    }
+
+    static Interval Whole() {
+        Interval Res;
+        Res.Lo = -std::numeric_limits<F>::infinity();
+        Res.Hi = std::numeric_limits<F>::infinity();
+        return Res;
+    }
+
+    // Interval around an approximation known to be within Ulps ulps of the true value
+    static Interval Around(F Approx, uint32_t Ulps) {
+        if (!std::isfinite(Approx)) return Whole();
+
+        Interval Res { Approx };
+        for (uint32_t i = 0; i < Ulps; ++i) {
+            Res.Lo = std::nextafter(Res.Lo, -std::numeric_limits<F>::infinity());
+            Res.Hi = std::nextafter(Res.Hi, std::numeric_limits<F>::infinity());
+        }
+        return Res;
+    }
+
+    // 1 or -1 if every value inside has that sign, 0 if the interval touches or straddles zero
+    int32_t Sign() const {
+        if (Lo > 0) return 1;
+        if (Hi < 0) return -1;
+        return 0;
+    }
+
+    Interval operator-() const {
+        return { -Hi, -Lo };
+    }
+    Interval& operator+=(const Interval& Other) {
+        *this = { Down(Lo + Other.Lo), Up(Hi + Other.Hi) };
+        return *this;
+    }
+    Interval operator+(Interval Other) const {
+        Other += *this;
+        return Other;
+    }
+    Interval& operator-=(const Interval& Other) {
+        *this += -Other;
+        return *this;
+    }
+    Interval operator-(const Interval& Other) const {
+        Interval Res = *this;
+        Res -= Other;
+        return Res;
+    }
+    Interval& operator*=(const Interval& Other) {
+        const F A = Lo * Other.Lo;
+        const F B = Lo * Other.Hi;
+        const F C = Hi * Other.Lo;
+        const F D = Hi * Other.Hi;
+
+        if (std::isnan(A) || std::isnan(B) || std::isnan(C) || std::isnan(D)) {
+            *this = Whole();
+        } else {
+            *this = { Down(std::min({ A, B, C, D })), Up(std::max({ A, B, C, D })) };
+        }
+        return *this;
+    }
+    Interval operator*(Interval Other) const {
+        Other *= *this;
+        return Other;
+    }
+
+private:
+    static F Down(F Val) {
+        return std::nextafter(Val, -std::numeric_limits<F>::infinity());
+    }
+    static F Up(F Val) {
+        return std::nextafter(Val, std::numeric_limits<F>::infinity());
+    }
+};
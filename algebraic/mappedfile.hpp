@@ -0,0 +1,169 @@
+#pragma once
+
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <stdint.h>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// A whole file mapped read-only into memory, pages are loaded as they are touched
+// Pair with ArchiveView to read serialized values straight out of the mapping
+class MappedFile {
+    const uint8_t* Data = nullptr;
+    size_t Length = 0;
+
+#ifdef _WIN32
+    HANDLE File = INVALID_HANDLE_VALUE;
+    HANDLE Mapping = nullptr;
+#endif
+
+    void Close() {
+#ifdef _WIN32
+        if (Data) UnmapViewOfFile(Data);
+        if (Mapping) CloseHandle(Mapping);
+        if (File != INVALID_HANDLE_VALUE) CloseHandle(File);
+        File = INVALID_HANDLE_VALUE;
+        Mapping = nullptr;
+#else
+        if (Data) munmap(const_cast<uint8_t*>(Data), Length);
+#endif
+        Data = nullptr;
+        Length = 0;
+    }
+
+public:
+    explicit MappedFile(const std::string& Path) {
+#ifdef _WIN32
+        File = CreateFileA(Path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (File == INVALID_HANDLE_VALUE) throw std::runtime_error("Can't open " + Path);
+
+        LARGE_INTEGER Size;
+        if (!GetFileSizeEx(File, &Size)) {
+            Close();
+            throw std::runtime_error("Can't read the size of " + Path);
+        }
+        Length = static_cast<size_t>(Size.QuadPart);
+        // Empty files can't be mapped, and have nothing to map anyway
+        if (Length == 0) return;
+
+        Mapping = CreateFileMappingA(File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (Mapping) Data = static_cast<const uint8_t*>(MapViewOfFile(Mapping, FILE_MAP_READ, 0, 0, 0));
+        if (!Data) {
+            Close();
+            throw std::runtime_error("Can't map " + Path);
+        }
+#else
+        const int Fd = open(Path.c_str(), O_RDONLY);
+        if (Fd < 0) throw std::runtime_error("Can't open " + Path);
+
+        struct stat Info;
+        if (fstat(Fd, &Info) != 0) {
+            close(Fd);
+            throw std::runtime_error("Can't read the size of " + Path);
+        }
+        Length = static_cast<size_t>(Info.st_size);
+        if (Length == 0) {
+            close(Fd);
+            return;
+        }
+
+        // The mapping keeps its own reference to the file
+        void* Mapped = mmap(nullptr, Length, PROT_READ, MAP_PRIVATE, Fd, 0);
+        close(Fd);
+        if (Mapped == MAP_FAILED) {
+            Length = 0;
+            throw std::runtime_error("Can't map " + Path);
+        }
+        Data = static_cast<const uint8_t*>(Mapped);
+#endif
+    }
+    ~MappedFile() {
+        Close();
+    }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    std::span<const uint8_t> Bytes() const {
+        return std::span<const uint8_t>(Data, Length);
+    }
+};
+
+// A file of a fixed size created, or truncated, and mapped read-write, writes reach the file through the page cache
+// so the whole of it never has to be in memory at once
+class MappedOutput {
+    uint8_t* Data = nullptr;
+    size_t Length = 0;
+
+#ifdef _WIN32
+    HANDLE File = INVALID_HANDLE_VALUE;
+    HANDLE Mapping = nullptr;
+#endif
+
+    void Close() {
+#ifdef _WIN32
+        if (Data) UnmapViewOfFile(Data);
+        if (Mapping) CloseHandle(Mapping);
+        if (File != INVALID_HANDLE_VALUE) CloseHandle(File);
+        File = INVALID_HANDLE_VALUE;
+        Mapping = nullptr;
+#else
+        if (Data) munmap(Data, Length);
+#endif
+        Data = nullptr;
+        Length = 0;
+    }
+
+public:
+    MappedOutput(const std::string& Path, size_t Size) : Length(Size) {
+        if (Size == 0) throw std::runtime_error("Can't map an empty output " + Path);
+
+#ifdef _WIN32
+        File = CreateFileA(Path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (File == INVALID_HANDLE_VALUE) throw std::runtime_error("Can't create " + Path);
+
+        // Mapping past the end grows the file to the mapping's size
+        const uint64_t Wide = Size;
+        Mapping = CreateFileMappingA(File, nullptr, PAGE_READWRITE, static_cast<DWORD>(Wide >> 32), static_cast<DWORD>(Wide), nullptr);
+        if (Mapping) Data = static_cast<uint8_t*>(MapViewOfFile(Mapping, FILE_MAP_WRITE, 0, 0, 0));
+        if (!Data) {
+            Close();
+            throw std::runtime_error("Can't map " + Path);
+        }
+#else
+        const int Fd = open(Path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (Fd < 0) throw std::runtime_error("Can't create " + Path);
+        if (ftruncate(Fd, static_cast<off_t>(Size)) != 0) {
+            close(Fd);
+            throw std::runtime_error("Can't size " + Path);
+        }
+
+        void* Mapped = mmap(nullptr, Size, PROT_READ | PROT_WRITE, MAP_SHARED, Fd, 0);
+        close(Fd);
+        if (Mapped == MAP_FAILED) {
+            Length = 0;
+            throw std::runtime_error("Can't map " + Path);
+        }
+        Data = static_cast<uint8_t*>(Mapped);
+#endif
+    }
+    ~MappedOutput() {
+        Close();
+    }
+    MappedOutput(const MappedOutput&) = delete;
+    MappedOutput& operator=(const MappedOutput&) = delete;
+
+    std::span<uint8_t> Bytes() {
+        return std::span<uint8_t>(Data, Length);
+    }
+};
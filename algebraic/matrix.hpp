@@ -0,0 +1,454 @@
+#pragma once
+
+#include "polynomial.hpp"
+#include "modint.hpp"
+#include "workpool.hpp"
+
+#include <vector>
+
+// Dense exact matrix
+// Entries are stored in TileSize x TileSize tiles, each row-major and contiguous, tiles ordered row by row.
+// Products walk whole tiles so the working set stays in cache, and a row is still TileSize-long contiguous runs
+// Integers (anything with DivideExact) are eliminated fraction-free with Bareiss' algorithm, fractions are first
+// scaled row by row to integers, and fields (anything with Inverse, like ModInt) use plain Gaussian elimination
+template<typename T = Rational<>>
+class Matrix {
+    template<typename> friend class Matrix;
+
+public:
+    static constexpr size_t TileSize = 16;
+
+    // Row updates of one elimination step go to the pool once they cover this many entries
+    static constexpr size_t ParallelThreshold = 4096;
+
+private:
+    size_t NumRows = 0;
+    size_t NumCols = 0;
+    size_t TileCols = 0;
+    std::vector<T> Data;
+
+    static constexpr bool FractionFree = requires(const T& Val) {
+        T(Val.Numerator(), Val.Denominator());
+    };
+
+    template<typename C>
+    static constexpr bool Integral = requires(const C& Val) {
+        C::DivideExact(Val, Val);
+    };
+
+    template<typename C>
+    static constexpr bool Field = requires(const C& Val) {
+        Val.Inverse();
+    };
+
+    size_t Index(size_t Row, size_t Col) const {
+        const size_t Tile = (Row / TileSize) * TileCols + Col / TileSize;
+        return Tile * TileSize * TileSize + (Row % TileSize) * TileSize + Col % TileSize;
+    }
+
+    void SwapRows(size_t A, size_t B) {
+        if (A == B) return;
+        for (size_t Col = 0; Col < NumCols; Col += TileSize) {
+            std::swap_ranges(Data.begin() + Index(A, Col), Data.begin() + Index(A, Col) + TileSize, Data.begin() + Index(B, Col));
+        }
+    }
+
+    // Scales every row to integers, OutScales[i] is the least common denominator of row i
+    template<typename Integer>
+    Matrix<Integer> ToIntegerRows(std::vector<Integer>& OutScales) const {
+        Matrix<Integer> Res(NumRows, NumCols);
+        OutScales.assign(NumRows, Integer(1));
+        for (size_t Row = 0; Row < NumRows; ++Row) {
+            Integer& Scale = OutScales[Row];
+            for (size_t Col = 0; Col < NumCols; ++Col) {
+                const Integer Den = (*this)(Row, Col).Denominator();
+                if (Den != Integer(1)) Scale = Scale / Integer::GCD(Scale, Den) * Den;
+            }
+            for (size_t Col = 0; Col < NumCols; ++Col) {
+                const T& Val = (*this)(Row, Col);
+                if (!Val.IsZero()) Res(Row, Col) = Val.Numerator() * (Scale / Val.Denominator());
+            }
+        }
+        return Res;
+    }
+
+    // Row echelon form in place, returns the pivot column of every nonzero row and flips OutSign per row swap
+    // With Reduce, entries above each pivot are eliminated too. Fraction-free, that leaves every pivot equal to the
+    // last one, which is the determinant of the pivot minor. Over a field the pivots are left as they come
+    template<typename C>
+    static std::vector<size_t> Eliminate(Matrix<C>& M, bool Reduce, int32_t& OutSign, WorkPool* Pool) {
+        OutSign = 1;
+
+        std::vector<size_t> PivotCols;
+        C Previous(1);
+        for (size_t Col = 0; Col < M.NumCols && PivotCols.size() < M.NumRows; ++Col) {
+            const size_t Top = PivotCols.size();
+
+            size_t Found = Top;
+            while (Found < M.NumRows && M(Found, Col).IsZero()) ++Found;
+            if (Found == M.NumRows) continue;
+
+            if (Found != Top) {
+                M.SwapRows(Found, Top);
+                OutSign = -OutSign;
+            }
+            PivotCols.push_back(Col);
+
+            const C Pivot = M(Top, Col);
+            C PivotInverse;
+            if constexpr (Field<C>) PivotInverse = Pivot.Inverse();
+
+            // Rows below have nothing left of Col, rows above can still hold entries in non-pivot columns
+            auto UpdateRow = [&](size_t Row) {
+                if (Row == Top) return;
+                const size_t First = Row > Top ? Col + 1 : 0;
+                const C Factor = M(Row, Col);
+
+                if constexpr (Field<C>) {
+                    if (Factor.IsZero()) return;
+                    const C Scaled = Factor * PivotInverse;
+                    for (size_t j = First; j < M.NumCols; ++j) {
+                        const C& Source = M(Top, j);
+                        if (!Source.IsZero()) M(Row, j) -= Scaled * Source;
+                    }
+                } else {
+                    // Bareiss: (Pivot * Entry - Factor * Source) / Previous is exact, it is a minor of the input
+                    for (size_t j = First; j < M.NumCols; ++j) {
+                        if (j == Col) continue;
+                        C& Entry = M(Row, j);
+                        const C& Source = M(Top, j);
+                        C Val = Pivot * Entry;
+                        if (!Factor.IsZero() && !Source.IsZero()) Val -= Factor * Source;
+                        Entry = Previous == C(1) ? std::move(Val) : C::DivideExact(std::move(Val), Previous);
+                    }
+                }
+                M(Row, Col) = C(0);
+            };
+
+            const size_t Begin = Reduce ? 0 : Top + 1;
+            if (Pool && (M.NumRows - Begin) * (M.NumCols - Col) >= ParallelThreshold) {
+                Pool->ForEach(Begin, M.NumRows, UpdateRow);
+            } else {
+                for (size_t Row = Begin; Row < M.NumRows; ++Row) UpdateRow(Row);
+            }
+
+            if constexpr (!Field<C>) Previous = Pivot;
+        }
+
+        return PivotCols;
+    }
+
+    // Determinant of a square matrix over an integral type or a field
+    template<typename C>
+    static C DeterminantOf(Matrix<C> M, WorkPool* Pool) {
+        int32_t Sign;
+        const std::vector<size_t> PivotCols = Eliminate(M, false, Sign, Pool);
+        if (PivotCols.size() < M.NumRows) return C(0);
+
+        C Res(1);
+        if constexpr (Field<C>) {
+            for (size_t i = 0; i < M.NumRows; ++i) Res *= M(i, i);
+        } else {
+            Res = M(M.NumRows - 1, M.NumCols - 1);
+        }
+        return Sign < 0 ? -Res : Res;
+    }
+
+    // Basis of the nullspace from the reduced form, one vector per non-pivot column
+    template<typename C>
+    static std::vector<std::vector<C>> NullspaceOf(Matrix<C> M, std::vector<size_t>& OutFree, WorkPool* Pool) {
+        int32_t Sign;
+        const std::vector<size_t> PivotCols = Eliminate(M, true, Sign, Pool);
+
+        std::vector<bool> IsPivot(M.NumCols, false);
+        for (size_t Col : PivotCols) IsPivot[Col] = true;
+
+        std::vector<std::vector<C>> Res;
+        for (size_t Free = 0; Free < M.NumCols; ++Free) {
+            if (IsPivot[Free]) continue;
+            OutFree.push_back(Free);
+
+            // Pivot row i reads Pivot_i * x[PivotCols[i]] + M(i, Free) * x[Free] = 0
+            std::vector<C> Vec(M.NumCols, C(0));
+            if constexpr (Field<C>) {
+                // A pivot over itself is a 1 that carries what the entries carry, such as a ModInt's modulus
+                Vec[Free] = PivotCols.empty() ? C(1) : M(0, PivotCols[0]) / M(0, PivotCols[0]);
+                for (size_t i = 0; i < PivotCols.size(); ++i) {
+                    Vec[PivotCols[i]] = -(M(i, Free) / M(i, PivotCols[i]));
+                }
+            } else {
+                // Every pivot is the same D, so x[Free] = D keeps the vector integral
+                Vec[Free] = PivotCols.empty() ? C(1) : M(PivotCols.size() - 1, PivotCols.back());
+                for (size_t i = 0; i < PivotCols.size(); ++i) {
+                    Vec[PivotCols[i]] = -M(i, Free);
+                }
+
+                C Common(0);
+                for (const C& Val : Vec) {
+                    if (!Val.IsZero()) Common = Common.IsZero() ? Val : C::GCD(Common, Val);
+                }
+                if (Common.Sign() < 0) Common = -Common;
+                for (C& Val : Vec) {
+                    if (!Val.IsZero()) Val = C::DivideExact(std::move(Val), Common);
+                }
+            }
+            Res.push_back(std::move(Vec));
+        }
+        return Res;
+    }
+
+public:
+    Matrix() = default;
+    Matrix(size_t Rows, size_t Cols) : NumRows(Rows), NumCols(Cols), TileCols((Cols + TileSize - 1) / TileSize) {
+        const size_t TileRows = (Rows + TileSize - 1) / TileSize;
+        Data.resize(TileRows * TileCols * TileSize * TileSize, T(0));
+    }
+
+    static Matrix Identity(size_t Size) {
+        Matrix Res(Size, Size);
+        for (size_t i = 0; i < Size; ++i) Res(i, i) = T(1);
+        return Res;
+    }
+    static Matrix FromRows(const std::vector<std::vector<T>>& Rows) {
+        Matrix Res(Rows.size(), Rows.empty() ? 0 : Rows[0].size());
+        for (size_t Row = 0; Row < Rows.size(); ++Row) {
+            if (Rows[Row].size() != Res.NumCols) throw std::runtime_error("Rows of different lengths");
+            for (size_t Col = 0; Col < Res.NumCols; ++Col) Res(Row, Col) = Rows[Row][Col];
+        }
+        return Res;
+    }
+
+    // Sylvester matrix of A and B, its determinant is their resultant
+    static Matrix Sylvester(const Polynomial<T>& A, const Polynomial<T>& B) {
+        const size_t M = A.IsZero() ? 0 : A.Degree();
+        const size_t N = B.IsZero() ? 0 : B.Degree();
+
+        Matrix Res(M + N, M + N);
+        for (const auto& t : A.GetTerms()) {
+            for (size_t Row = 0; Row < N; ++Row) Res(Row, Row + M - t.Exp) = t.Cof;
+        }
+        for (const auto& t : B.GetTerms()) {
+            for (size_t Row = 0; Row < M; ++Row) Res(N + Row, Row + N - t.Exp) = t.Cof;
+        }
+        return Res;
+    }
+
+    size_t Rows() const {
+        return NumRows;
+    }
+    size_t Cols() const {
+        return NumCols;
+    }
+
+    T& operator()(size_t Row, size_t Col) {
+        return Data[Index(Row, Col)];
+    }
+    const T& operator()(size_t Row, size_t Col) const {
+        return Data[Index(Row, Col)];
+    }
+
+    static Matrix Transpose(const Matrix& Val) {
+        Matrix Res(Val.NumCols, Val.NumRows);
+        for (size_t Row = 0; Row < Val.NumRows; ++Row) {
+            for (size_t Col = 0; Col < Val.NumCols; ++Col) Res(Col, Row) = Val(Row, Col);
+        }
+        return Res;
+    }
+
+    static T Determinant(const Matrix& Val, WorkPool* Pool = nullptr) {
+        if (Val.NumRows != Val.NumCols) throw std::runtime_error("Determinant of a non-square matrix");
+        if (Val.NumRows == 0) return T(1);
+
+        if constexpr (FractionFree) {
+            std::vector<decltype(T().Numerator())> Scales;
+            auto Scaled = Val.ToIntegerRows(Scales);
+
+            auto Den = Scales[0];
+            for (size_t i = 1; i < Scales.size(); ++i) Den *= Scales[i];
+            return T(DeterminantOf(std::move(Scaled), Pool), Den);
+        } else {
+            return DeterminantOf(Val, Pool);
+        }
+    }
+
+    static size_t Rank(const Matrix& Val, WorkPool* Pool = nullptr) {
+        int32_t Sign;
+        if constexpr (FractionFree) {
+            std::vector<decltype(T().Numerator())> Scales;
+            auto Scaled = Val.ToIntegerRows(Scales);
+            return Eliminate(Scaled, false, Sign, Pool).size();
+        } else {
+            Matrix Copy = Val;
+            return Eliminate(Copy, false, Sign, Pool).size();
+        }
+    }
+
+    // Basis of { x : Val * x = 0 }, one vector per free column with that entry set to 1 for fractions and fields,
+    // and primitive integer vectors for integers
+    static std::vector<std::vector<T>> Nullspace(const Matrix& Val, WorkPool* Pool = nullptr) {
+        if constexpr (FractionFree) {
+            std::vector<decltype(T().Numerator())> Scales;
+            std::vector<size_t> Free;
+            const auto Basis = NullspaceOf(Val.ToIntegerRows(Scales), Free, Pool);
+
+            std::vector<std::vector<T>> Res;
+            for (size_t i = 0; i < Basis.size(); ++i) {
+                std::vector<T> Scaled;
+                for (const auto& Entry : Basis[i]) Scaled.push_back(Entry.IsZero() ? T(0) : T(Entry, Basis[i][Free[i]]));
+                Res.push_back(std::move(Scaled));
+            }
+            return Res;
+        } else {
+            std::vector<size_t> Free;
+            return NullspaceOf(Val, Free, Pool);
+        }
+    }
+
+    // Determinant of an integer matrix from its residues modulo enough primes, then Chinese remaindering
+    // Hadamard's bound |det| <= product of the row norms says how many primes are enough. Every prime is an
+    // independent elimination on machine words, so with a Pool they run concurrently
+    static T DeterminantModular(const Matrix& Val, WorkPool* Pool = nullptr) requires Integral<T> {
+        if (Val.NumRows != Val.NumCols) throw std::runtime_error("Determinant of a non-square matrix");
+        const size_t N = Val.NumRows;
+        if (N == 0) return T(1);
+
+        // log2 of the bound, rounded up per row, plus a bit for the sign
+        size_t BoundBits = 1;
+        for (size_t Row = 0; Row < N; ++Row) {
+            T NormSquared(0);
+            for (size_t Col = 0; Col < N; ++Col) NormSquared += Val(Row, Col) * Val(Row, Col);
+            if (NormSquared.IsZero()) return T(0);
+            BoundBits += (NormSquared.TopBitIndex() + 2) / 2;
+        }
+
+        // Every prime is above 2^30
+        const std::vector<uint32_t> Primes = ModInt::LargePrimes(BoundBits / 30 + 1);
+        std::vector<ModInt> Residues(Primes.size());
+
+        auto Solve = [&](size_t i) {
+            Matrix<ModInt> Reduced(N, N);
+            for (size_t Row = 0; Row < N; ++Row) {
+                for (size_t Col = 0; Col < N; ++Col) Reduced(Row, Col) = ModInt::FromInteger(Val(Row, Col), Primes[i]);
+            }
+            Residues[i] = ModInt(0, Primes[i]) + Matrix<ModInt>::DeterminantOf(std::move(Reduced), nullptr);
+        };
+        if (Pool) {
+            Pool->ForEach(0, Primes.size(), Solve);
+        } else {
+            for (size_t i = 0; i < Primes.size(); ++i) Solve(i);
+        }
+
+        // Garner: keep Res mod Product, add the multiple of Product that fixes the next residue
+        T Res(0);
+        T Product(1);
+        for (size_t i = 0; i < Primes.size(); ++i) {
+            const ModInt Current = ModInt::FromInteger(Res, Primes[i]);
+            const ModInt Step = (Residues[i] - Current) / ModInt::FromInteger(Product, Primes[i]);
+            Res += Product * T(static_cast<int64_t>(Step.Value()));
+            Product *= T(static_cast<int64_t>(Primes[i]));
+        }
+
+        // Symmetric range
+        if (Res + Res > Product) Res -= Product;
+        return Res;
+    }
+
+    Matrix& operator+=(const Matrix& Other) {
+        if (NumRows != Other.NumRows || NumCols != Other.NumCols) throw std::runtime_error("Matrix sizes differ");
+        for (size_t i = 0; i < Data.size(); ++i) Data[i] += Other.Data[i];
+        return *this;
+    }
+    Matrix operator+(const Matrix& Other) const {
+        Matrix Res = *this;
+        Res += Other;
+        return Res;
+    }
+    Matrix& operator-=(const Matrix& Other) {
+        if (NumRows != Other.NumRows || NumCols != Other.NumCols) throw std::runtime_error("Matrix sizes differ");
+        for (size_t i = 0; i < Data.size(); ++i) Data[i] -= Other.Data[i];
+        return *this;
+    }
+    Matrix operator-(const Matrix& Other) const {
+        Matrix Res = *this;
+        Res -= Other;
+        return Res;
+    }
+
+    // Tile by tile, fractions multiplied as integers over row and column denominators
+    Matrix operator*(const Matrix& Other) const {
+        if (NumCols != Other.NumRows) throw std::runtime_error("Matrix sizes differ");
+
+        if constexpr (FractionFree) {
+            std::vector<decltype(T().Numerator())> RowScales, ColScales;
+            const auto Left = ToIntegerRows(RowScales);
+            const auto Right = decltype(Left)::Transpose(Transpose(Other).ToIntegerRows(ColScales));
+            const auto Product = Left * Right;
+
+            Matrix Res(NumRows, Other.NumCols);
+            for (size_t Row = 0; Row < NumRows; ++Row) {
+                for (size_t Col = 0; Col < Other.NumCols; ++Col) {
+                    const auto& Num = Product(Row, Col);
+                    if (!Num.IsZero()) Res(Row, Col) = T(Num, RowScales[Row] * ColScales[Col]);
+                }
+            }
+            return Res;
+        } else {
+            Matrix Res(NumRows, Other.NumCols);
+            const size_t InnerTiles = TileCols;
+            for (size_t RowTile = 0; RowTile * TileSize < NumRows; ++RowTile) {
+                for (size_t ColTile = 0; ColTile < Res.TileCols; ++ColTile) {
+                    T* Out = &Res.Data[(RowTile * Res.TileCols + ColTile) * TileSize * TileSize];
+                    for (size_t InnerTile = 0; InnerTile < InnerTiles; ++InnerTile) {
+                        const T* A = &Data[(RowTile * TileCols + InnerTile) * TileSize * TileSize];
+                        const T* B = &Other.Data[(InnerTile * Other.TileCols + ColTile) * TileSize * TileSize];
+
+                        for (size_t i = 0; i < TileSize; ++i) {
+                            for (size_t k = 0; k < TileSize; ++k) {
+                                const T& Scale = A[i * TileSize + k];
+                                if (Scale.IsZero()) continue;
+                                for (size_t j = 0; j < TileSize; ++j) {
+                                    if (!B[k * TileSize + j].IsZero()) Out[i * TileSize + j] += Scale * B[k * TileSize + j];
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+            return Res;
+        }
+    }
+    Matrix& operator*=(const Matrix& Other) {
+        *this = *this * Other;
+        return *this;
+    }
+
+    bool operator==(const Matrix& Other) const {
+        if (NumRows != Other.NumRows || NumCols != Other.NumCols) return false;
+        for (size_t Row = 0; Row < NumRows; ++Row) {
+            for (size_t Col = 0; Col < NumCols; ++Col) {
+                if (!((*this)(Row, Col) - Other(Row, Col)).IsZero()) return false;
+            }
+        }
+        return true;
+    }
+    bool operator!=(const Matrix& Other) const {
+        return !(*this == Other);
+    }
+
+    static std::string ToString(const Matrix& Val, int64_t MaxDigits = 10) {
+        std::string Res;
+        for (size_t Row = 0; Row < Val.NumRows; ++Row) {
+            Res += "[";
+            for (size_t Col = 0; Col < Val.NumCols; ++Col) {
+                if (Col > 0) Res += ", ";
+                if constexpr (requires { T::ToString(Val(Row, Col), MaxDigits); }) {
+                    Res += T::ToString(Val(Row, Col), MaxDigits);
+                } else {
+                    Res += T::ToString(Val(Row, Col));
+                }
+            }
+            Res += "]\n";
+        }
+        return Res;
+    }
+};
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <stdexcept>
+#include <stdint.h>
+
+// Residue modulo a number below 2^31, the modulus travels with the value so one type serves any number of primes
+// Values built from plain integers have modulus 0, they stand for that nonnegative integer and take the
+// modulus of the first residue they are combined with. That keeps T(0) and T(1) usable in generic code
+class ModInt {
+    uint64_t Val = 0;
+    uint64_t Mod = 0;
+
+    static uint64_t CommonModulus(uint64_t LHS, uint64_t RHS) {
+        if (LHS != 0 && RHS != 0 && LHS != RHS) throw std::runtime_error("Mixing residues of different moduli");
+        return LHS != 0 ? LHS : RHS;
+    }
+    uint64_t ValueMod(uint64_t Modulus) const {
+        return Modulus == 0 ? Val : Val % Modulus;
+    }
+
+public:
+    static constexpr uint64_t MaxModulus = uint64_t(1) << 31;
+
+    ModInt() = default;
+    ModInt(int64_t Value) {
+        if (Value < 0) throw std::runtime_error("Negative constant needs a modulus");
+        Val = static_cast<uint64_t>(Value);
+    }
+    ModInt(int64_t Value, uint64_t Modulus) : Mod(Modulus) {
+        if (Modulus == 0 || Modulus > MaxModulus) throw std::runtime_error("Modulus out of range");
+
+        const int64_t Signed = Value % static_cast<int64_t>(Modulus);
+        Val = static_cast<uint64_t>(Signed < 0 ? Signed + static_cast<int64_t>(Modulus) : Signed);
+    }
+
+    // Residue of an arbitrary size integer, folding its words in from the top
+    template<typename Integer>
+    static ModInt FromInteger(const Integer& Value, uint64_t Modulus) {
+        static_assert(sizeof(Value[0]) <= 4, "Words must fit next to a residue in 64 bits");
+        constexpr size_t WordBits = sizeof(Value[0]) * 8;
+
+        ModInt Res(0, Modulus);
+        for (size_t i = Value.Size(); i-- > 0;) {
+            Res.Val = ((Res.Val << WordBits) | static_cast<uint64_t>(Value[i])) % Modulus;
+        }
+        return Value.Sign() < 0 ? -Res : Res;
+    }
+
+    // Count primes just below 2^31, largest first
+    static std::vector<uint32_t> LargePrimes(size_t Count) {
+        std::vector<uint32_t> Res;
+        for (uint32_t Candidate = static_cast<uint32_t>(MaxModulus - 1); Res.size() < Count; Candidate -= 2) {
+            bool Prime = true;
+            for (uint32_t d = 3; d * d <= Candidate; d += 2) {
+                if (Candidate % d == 0) {
+                    Prime = false;
+                    break;
+                }
+            }
+            if (Prime) Res.push_back(Candidate);
+        }
+        return Res;
+    }
+
+    uint64_t Value() const {
+        return Val;
+    }
+    uint64_t Modulus() const {
+        return Mod;
+    }
+    bool IsZero() const {
+        return ValueMod(Mod) == 0;
+    }
+
+    // Extended Euclid, so a modulus that isn't prime only fails for the residues sharing a factor with it
+    ModInt Inverse() const {
+        if (Mod == 0) throw std::runtime_error("Inverse needs a modulus");
+
+        int64_t A = static_cast<int64_t>(Val), B = static_cast<int64_t>(Mod);
+        int64_t X = 1, Y = 0;
+        while (B != 0) {
+            const int64_t Q = A / B;
+            A -= Q * B;
+            std::swap(A, B);
+            X -= Q * Y;
+            std::swap(X, Y);
+        }
+        if (A != 1) throw std::runtime_error("Attempting reciprocal of a non-invertible residue");
+
+        return ModInt(X, Mod);
+    }
+
+    static ModInt Pow(ModInt Base, uint64_t Exp) {
+        ModInt Res(1);
+        while (Exp > 0) {
+            if (Exp & 1) Res *= Base;
+            Exp >>= 1;
+            if (Exp > 0) Base *= Base;
+        }
+        return Res;
+    }
+
+    static std::string ToString(const ModInt& Val, int64_t = 0) {
+        return std::to_string(Val.Val) + " (mod " + std::to_string(Val.Mod) + ")";
+    }
+
+    ModInt operator-() const {
+        if (Mod == 0) {
+            if (Val != 0) throw std::runtime_error("Negative constant needs a modulus");
+            return *this;
+        }
+        ModInt Res = *this;
+        Res.Val = Val == 0 ? 0 : Mod - Val;
+        return Res;
+    }
+    ModInt& operator+=(const ModInt& Other) {
+        Mod = CommonModulus(Mod, Other.Mod);
+        Val = ValueMod(Mod) + Other.ValueMod(Mod);
+        if (Mod != 0 && Val >= Mod) Val -= Mod;
+        return *this;
+    }
+    ModInt operator+(ModInt Other) const {
+        Other += *this;
+        return Other;
+    }
+    ModInt& operator-=(const ModInt& Other) {
+        Mod = CommonModulus(Mod, Other.Mod);
+        if (Mod == 0) {
+            if (Other.Val > Val) throw std::runtime_error("Negative constant needs a modulus");
+            Val -= Other.Val;
+            return *this;
+        }
+        const uint64_t Sub = Other.ValueMod(Mod);
+        Val = ValueMod(Mod);
+        Val = Val >= Sub ? Val - Sub : Val + Mod - Sub;
+        return *this;
+    }
+    ModInt operator-(const ModInt& Other) const {
+        ModInt Res = *this;
+        Res -= Other;
+        return Res;
+    }
+    ModInt& operator*=(const ModInt& Other) {
+        Mod = CommonModulus(Mod, Other.Mod);
+        Val = ValueMod(Mod) * Other.ValueMod(Mod);
+        if (Mod != 0) Val %= Mod;
+        return *this;
+    }
+    ModInt operator*(ModInt Other) const {
+        Other *= *this;
+        return Other;
+    }
+    ModInt& operator/=(const ModInt& Other) {
+        ModInt Divisor = Other;
+        Divisor.Mod = CommonModulus(Mod, Other.Mod);
+        Divisor.Val = Other.ValueMod(Divisor.Mod);
+        *this *= Divisor.Inverse();
+        return *this;
+    }
+    ModInt operator/(const ModInt& Other) const {
+        ModInt Res = *this;
+        Res /= Other;
+        return Res;
+    }
+
+    bool operator==(const ModInt& Other) const {
+        const uint64_t Modulus = CommonModulus(Mod, Other.Mod);
+        return ValueMod(Modulus) == Other.ValueMod(Modulus);
+    }
+    bool operator!=(const ModInt& Other) const {
+        return !(*this == Other);
+    }
+};
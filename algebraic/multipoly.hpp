@@ -0,0 +1,391 @@
+#pragma once
+
+#include "polynomial.hpp"
+
+#include <array>
+#include <unordered_map>
+
+// Sparse polynomial in NumVars variables x0, x1, ...
+// A monomial packs every exponent into one uint64_t, BitsPerVar bits each with x0 in the lowest bits,
+// so multiplying two monomials is a single addition and a term lookup is a single hash of an integer
+template<typename T = Rational<>, uint32_t NumVars = 2>
+class MultiPolynomial {
+    static_assert(NumVars >= 1 && NumVars <= 8);
+
+public:
+    static constexpr uint32_t BitsPerVar = 64 / NumVars;
+    static constexpr uint64_t MaxExp = (uint64_t(1) << (BitsPerVar - 1)) - 1;
+
+    using Monomial = uint64_t;
+    using Exponents = std::array<uint32_t, NumVars>;
+
+private:
+    std::unordered_map<Monomial, T> Terms;
+
+    static constexpr Monomial VarMask = BitsPerVar == 64 ? ~uint64_t(0) : (uint64_t(1) << BitsPerVar) - 1;
+
+    // Same as Polynomial, sums of fractions are left unreduced by T::operator+=
+    static constexpr bool FractionFree = requires(const T& Val) {
+        T(Val.Numerator(), Val.Denominator());
+    };
+    static void ReduceCof(T& Val) {
+        if constexpr (FractionFree) {
+            Val = T(Val.Numerator(), Val.Denominator());
+        }
+    }
+
+    // Cof = Num / Den for every term, with Den the least common denominator
+    auto ToIntegerTerms() const {
+        using Integer = decltype(T().Numerator());
+
+        Integer Den(1);
+        for (const auto& [Mono, Cof] : Terms) {
+            const Integer CofDen = Cof.Denominator();
+            if (CofDen != Integer(1)) {
+                Den = Den / Integer::GCD(Den, CofDen) * CofDen;
+            }
+        }
+
+        std::vector<std::pair<Monomial, Integer>> Nums;
+        Nums.reserve(Terms.size());
+        for (const auto& [Mono, Cof] : Terms) {
+            Nums.push_back({ Mono, Cof.Numerator() * (Den / Cof.Denominator()) });
+        }
+        return std::make_pair(std::move(Nums), std::move(Den));
+    }
+
+    void normalize() {
+        for (auto It = Terms.begin(); It != Terms.end();) {
+            if (It->second.IsZero()) {
+                It = Terms.erase(It);
+            } else {
+                ++It;
+            }
+        }
+    }
+
+public:
+    static Monomial Pack(const Exponents& Exps) {
+        Monomial Res = 0;
+        for (uint32_t Var = 0; Var < NumVars; ++Var) {
+            if (Exps[Var] > MaxExp) throw std::runtime_error("Exponent does not fit in a packed monomial");
+            Res |= Monomial(Exps[Var]) << (Var * BitsPerVar);
+        }
+        return Res;
+    }
+    static Exponents Unpack(Monomial Mono) {
+        Exponents Res;
+        for (uint32_t Var = 0; Var < NumVars; ++Var) {
+            Res[Var] = static_cast<uint32_t>((Mono >> (Var * BitsPerVar)) & VarMask);
+        }
+        return Res;
+    }
+    static uint32_t ExpOf(Monomial Mono, uint32_t Var) {
+        return static_cast<uint32_t>((Mono >> (Var * BitsPerVar)) & VarMask);
+    }
+
+    MultiPolynomial() = default;
+    MultiPolynomial(T Cof) {
+        if (!Cof.IsZero()) Terms.emplace(Monomial(0), std::move(Cof));
+    }
+    MultiPolynomial(T Cof, const Exponents& Exps) {
+        if (!Cof.IsZero()) Terms.emplace(Pack(Exps), std::move(Cof));
+    }
+
+    // Var^Exp
+    static MultiPolynomial Variable(uint32_t Var, uint32_t Exp = 1) {
+        Exponents Exps {};
+        Exps[Var] = Exp;
+        return MultiPolynomial(T(1), Exps);
+    }
+
+    // P(x_Var)
+    static MultiPolynomial FromUnivariate(const Polynomial<T>& P, uint32_t Var) {
+        MultiPolynomial Res;
+        for (const auto& t : P.GetTerms()) {
+            Exponents Exps {};
+            Exps[Var] = t.Exp;
+            Res.Terms.emplace(Pack(Exps), t.Cof);
+        }
+        return Res;
+    }
+
+    // P(Q), Horner with every distinct power of Q computed once
+    static MultiPolynomial Substitute(const Polynomial<T>& P, const MultiPolynomial& Q) {
+        const auto& PTerms = P.GetTerms();
+        if (PTerms.empty()) return {};
+
+        std::unordered_map<uint32_t, MultiPolynomial> QPowers;
+        auto MulPower = [&](MultiPolynomial& Val, uint32_t Exp) {
+            if (Exp == 0) return;
+            auto It = QPowers.find(Exp);
+            if (It == QPowers.end()) It = QPowers.emplace(Exp, Pow(Q, Exp)).first;
+            Val *= It->second;
+        };
+
+        MultiPolynomial Res(PTerms.back().Cof);
+        for (size_t i = PTerms.size() - 1; i-- > 0;) {
+            MulPower(Res, PTerms[i + 1].Exp - PTerms[i].Exp);
+            Res += MultiPolynomial(PTerms[i].Cof);
+        }
+        MulPower(Res, PTerms.front().Exp);
+
+        return Res;
+    }
+
+    const std::unordered_map<Monomial, T>& GetTerms() const {
+        return Terms;
+    }
+    size_t NumTerms() const {
+        return Terms.size();
+    }
+    bool IsZero() const {
+        return Terms.empty();
+    }
+    T GetCof(const Exponents& Exps) const {
+        auto It = Terms.find(Pack(Exps));
+        return It == Terms.end() ? T(0) : It->second;
+    }
+
+    // Highest exponent of Var in any term, 0 for the zero polynomial
+    uint32_t Degree(uint32_t Var) const {
+        uint32_t Res = 0;
+        for (const auto& [Mono, Cof] : Terms) {
+            Res = std::max(Res, ExpOf(Mono, Var));
+        }
+        return Res;
+    }
+    uint32_t TotalDegree() const {
+        uint32_t Res = 0;
+        for (const auto& [Mono, Cof] : Terms) {
+            uint32_t Sum = 0;
+            for (uint32_t Var = 0; Var < NumVars; ++Var) Sum += ExpOf(Mono, Var);
+            Res = std::max(Res, Sum);
+        }
+        return Res;
+    }
+
+    // Coefficients as polynomials in the other variables, Res[k] belongs to x_Var^k
+    std::vector<MultiPolynomial> CoefficientsIn(uint32_t Var) const {
+        std::vector<MultiPolynomial> Res(IsZero() ? 0 : Degree(Var) + 1);
+        const Monomial Mask = ~(VarMask << (Var * BitsPerVar));
+        for (const auto& [Mono, Cof] : Terms) {
+            Res[ExpOf(Mono, Var)].Terms.emplace(Mono & Mask, Cof);
+        }
+        return Res;
+    }
+
+    // Only defined when Var is the single variable that appears
+    Polynomial<T> ToUnivariate(uint32_t Var) const {
+        const Monomial Mask = ~(VarMask << (Var * BitsPerVar));
+
+        std::vector<T> Cofs(IsZero() ? 0 : Degree(Var) + 1, T(0));
+        for (const auto& [Mono, Cof] : Terms) {
+            if ((Mono & Mask) != 0) throw std::runtime_error("Polynomial depends on more than one variable");
+            Cofs[ExpOf(Mono, Var)] = Cof;
+        }
+        return Polynomial<T>::FromDense(Cofs);
+    }
+
+    // Substitute Value for x_Var, Var no longer appears in the result
+    MultiPolynomial Evaluate(uint32_t Var, const T& Value) const {
+        const std::vector<T> Powers = Polynomial<T>::MakePowers(Value, Degree(Var));
+        const Monomial Mask = ~(VarMask << (Var * BitsPerVar));
+
+        MultiPolynomial Res;
+        Res.Terms.reserve(Terms.size());
+        for (const auto& [Mono, Cof] : Terms) {
+            const uint32_t Exp = ExpOf(Mono, Var);
+            const T Val = Exp == 0 ? Cof : Cof * (Exp < Powers.size() ? Powers[Exp] : T::Pow(Value, Exp));
+
+            auto [It, Inserted] = Res.Terms.emplace(Mono & Mask, Val);
+            if (!Inserted) It->second += Val;
+        }
+        for (auto& [Mono, Cof] : Res.Terms) ReduceCof(Cof);
+        Res.normalize();
+        return Res;
+    }
+    // Value at a point, Values[i] is substituted for x_i
+    T Evaluate(const std::array<T, NumVars>& Values) const {
+        MultiPolynomial Res = *this;
+        for (uint32_t Var = 0; Var < NumVars; ++Var) {
+            Res = Res.Evaluate(Var, Values[Var]);
+        }
+        return Res.GetCof({});
+    }
+
+    // Resultant of A and B with respect to x_Var, as a polynomial in the one remaining variable
+    // Only for bivariate polynomials. Evaluates the other variable at enough integers, takes univariate
+    // resultants there and interpolates. Points where either leading coefficient in x_Var vanishes are
+    // skipped, the resultant of the specializations would have the wrong degree there
+    static Polynomial<T> Resultant(const MultiPolynomial& A, const MultiPolynomial& B, uint32_t Var) requires (NumVars == 2) {
+        const uint32_t Other = 1 - Var;
+
+        const std::vector<MultiPolynomial> ACofs = A.CoefficientsIn(Var);
+        const std::vector<MultiPolynomial> BCofs = B.CoefficientsIn(Var);
+        if (ACofs.empty() || BCofs.empty()) return {};
+
+        // Every entry of the Sylvester matrix is a coefficient, so its determinant has at most this degree
+        const uint32_t MaxDegree = A.Degree(Var) * B.Degree(Other) + B.Degree(Var) * A.Degree(Other);
+
+        std::vector<T> Points, Values;
+        for (int64_t s = 0; Points.size() <= MaxDegree; ++s) {
+            const T Point(s);
+            if (ACofs.back().Evaluate(Other, Point).IsZero() || BCofs.back().Evaluate(Other, Point).IsZero()) continue;
+
+            Points.push_back(Point);
+            Values.push_back(Polynomial<T>::Resultant(
+                A.Evaluate(Other, Point).ToUnivariate(Var),
+                B.Evaluate(Other, Point).ToUnivariate(Var)
+            ));
+        }
+
+        return Polynomial<T>::Interpolate(Points, Values);
+    }
+
+    static MultiPolynomial Pow(MultiPolynomial Base, uint32_t Exp) {
+        MultiPolynomial Res(T(1));
+        while (Exp > 0) {
+            if (Exp & 1) Res *= Base;
+            Exp >>= 1;
+            if (Exp > 0) Base *= Base;
+        }
+        return Res;
+    }
+
+    static std::string ToString(const MultiPolynomial& Val, int64_t MaxDigits = 10) {
+        if (Val.IsZero()) return "0";
+
+        // Highest total degree first, ties broken by the packed monomial so the output is stable
+        std::vector<std::pair<Monomial, const T*>> Sorted;
+        for (const auto& [Mono, Cof] : Val.Terms) Sorted.push_back({ Mono, &Cof });
+        auto TotalOf = [](Monomial Mono) {
+            uint32_t Sum = 0;
+            for (uint32_t Var = 0; Var < NumVars; ++Var) Sum += ExpOf(Mono, Var);
+            return Sum;
+        };
+        std::sort(Sorted.begin(), Sorted.end(), [&](const auto& L, const auto& R) {
+            const uint32_t LT = TotalOf(L.first), RT = TotalOf(R.first);
+            return LT != RT ? LT > RT : L.first > R.first;
+        });
+
+        std::string Res;
+        for (size_t i = 0; i < Sorted.size(); ++i) {
+            const auto& [Mono, CofPtr] = Sorted[i];
+            T Cof = *CofPtr;
+
+            if (i > 0) {
+                Res += Cof < 0 ? " - " : " + ";
+                if (Cof < 0) Cof = -Cof;
+            }
+
+            std::string Vars;
+            for (uint32_t Var = 0; Var < NumVars; ++Var) {
+                const uint32_t Exp = ExpOf(Mono, Var);
+                if (Exp == 0) continue;
+                Vars += "x" + std::to_string(Var);
+                if (Exp > 1) Vars += "^" + std::to_string(Exp);
+            }
+
+            if (Cof != 1 || Vars.empty()) Res += T::ToString(Cof, MaxDigits);
+            Res += Vars;
+        }
+        return Res;
+    }
+
+    MultiPolynomial operator-() const {
+        MultiPolynomial Res = *this;
+        for (auto& [Mono, Cof] : Res.Terms) {
+            Cof.ApplyNegate();
+        }
+        return Res;
+    }
+    MultiPolynomial& operator+=(const MultiPolynomial& Other) {
+        for (const auto& [Mono, Cof] : Other.Terms) {
+            auto [It, Inserted] = Terms.emplace(Mono, Cof);
+            if (!Inserted) {
+                It->second += Cof;
+                ReduceCof(It->second);
+                if (It->second.IsZero()) Terms.erase(It);
+            }
+        }
+        return *this;
+    }
+    MultiPolynomial operator+(MultiPolynomial Other) const {
+        Other += *this;
+        return Other;
+    }
+    MultiPolynomial& operator-=(const MultiPolynomial& Other) {
+        return *this += -Other;
+    }
+    MultiPolynomial operator-(const MultiPolynomial& Other) const {
+        MultiPolynomial Res = *this;
+        Res -= Other;
+        return Res;
+    }
+    // Every product of terms lands in the hash map directly
+    // Fractions are multiplied as integers over a common denominator, so each result term is reduced once
+    // instead of once per product
+    MultiPolynomial& operator*=(const MultiPolynomial& Other) {
+        if (IsZero() || Other.IsZero()) {
+            Terms.clear();
+            return *this;
+        }
+        for (uint32_t Var = 0; Var < NumVars; ++Var) {
+            if (uint64_t(Degree(Var)) + Other.Degree(Var) > MaxExp) {
+                throw std::runtime_error("Exponent does not fit in a packed monomial");
+            }
+        }
+
+        MultiPolynomial Res;
+        Res.Terms.reserve(Terms.size() * Other.Terms.size());
+
+        if constexpr (FractionFree) {
+            auto [LNums, LDen] = ToIntegerTerms();
+            auto [RNums, RDen] = Other.ToIntegerTerms();
+            using Integer = decltype(LDen);
+
+            std::unordered_map<Monomial, Integer> Sums;
+            Sums.reserve(Terms.size() * Other.Terms.size());
+            for (const auto& [LMono, LNum] : LNums) {
+                for (const auto& [RMono, RNum] : RNums) {
+                    auto [It, Inserted] = Sums.emplace(LMono + RMono, LNum * RNum);
+                    if (!Inserted) It->second += LNum * RNum;
+                }
+            }
+
+            const Integer Den = LDen * RDen;
+            for (const auto& [Mono, Num] : Sums) {
+                if (!Num.IsZero()) Res.Terms.emplace(Mono, T(Num, Den));
+            }
+        } else {
+            for (const auto& [LMono, LCof] : Terms) {
+                for (const auto& [RMono, RCof] : Other.Terms) {
+                    auto [It, Inserted] = Res.Terms.emplace(LMono + RMono, LCof * RCof);
+                    if (!Inserted) It->second += LCof * RCof;
+                }
+            }
+            Res.normalize();
+        }
+
+        *this = std::move(Res);
+        return *this;
+    }
+    MultiPolynomial operator*(const MultiPolynomial& Other) const {
+        MultiPolynomial Res = *this;
+        Res *= Other;
+        return Res;
+    }
+
+    bool operator==(const MultiPolynomial& Other) const {
+        if (Terms.size() != Other.Terms.size()) return false;
+        for (const auto& [Mono, Cof] : Terms) {
+            auto It = Other.Terms.find(Mono);
+            if (It == Other.Terms.end() || !(It->second - Cof).IsZero()) return false;
+        }
+        return true;
+    }
+    bool operator!=(const MultiPolynomial& Other) const {
+        return !(*this == Other);
+    }
+};
@@ -0,0 +1,144 @@
+#pragma once
+
+#include "polynomial.hpp"
+#include "multipoly.hpp"
+
+// Q(α) for α a root of Modulus, elements are polynomials in α of degree below Modulus.Degree()
+// Modulus should be irreducible for this to be a field. Otherwise it is only a ring, and MinimalPolynomial
+// returns the least polynomial that vanishes at β for every root α at once
+template<typename T = Rational<>>
+class NumberField {
+    using Poly = Polynomial<T>;
+    using Integer = decltype(T().Numerator());
+
+    Poly Modulus;
+
+    // Row[i] = Cofs[i] * Scale with Scale the least common denominator, padded to Width
+    static std::vector<Integer> ToIntegerRow(const Poly& Val, size_t Width, Integer& OutScale) {
+        std::vector<T> Cofs = Val.ToDense();
+        Cofs.resize(Width, T(0));
+
+        OutScale = Integer(1);
+        for (const T& Cof : Cofs) {
+            const Integer CofDen = Cof.Denominator();
+            if (CofDen != Integer(1)) {
+                OutScale = OutScale / Integer::GCD(OutScale, CofDen) * CofDen;
+            }
+        }
+
+        std::vector<Integer> Row;
+        Row.reserve(Width);
+        for (const T& Cof : Cofs) {
+            Row.push_back(Cof.Numerator() * (OutScale / Cof.Denominator()));
+        }
+        return Row;
+    }
+
+public:
+    explicit NumberField(const Poly& Defining) {
+        if (Defining.Degree() < 1 || Defining.IsZero()) throw std::runtime_error("Number field needs a nonconstant modulus");
+
+        const T Lead = Defining.GetLeadingTerm().Cof;
+        for (const auto& t : Defining.GetTerms()) {
+            Modulus += Poly(t.Cof / Lead, t.Exp);
+        }
+    }
+
+    const Poly& GetModulus() const {
+        return Modulus;
+    }
+    uint32_t Degree() const {
+        return Modulus.Degree();
+    }
+
+    Poly Reduce(const Poly& Val) const {
+        return Val.Degree() < Degree() ? Val : Val % Modulus;
+    }
+    Poly Mul(const Poly& LHS, const Poly& RHS) const {
+        return Reduce(LHS * RHS);
+    }
+    Poly Pow(Poly Base, uint32_t Exp) const {
+        Poly Res(T(1), 0);
+        Base = Reduce(Base);
+        while (Exp > 0) {
+            if (Exp & 1) Res = Mul(Res, Base);
+            Exp >>= 1;
+            if (Exp > 0) Base = Mul(Base, Base);
+        }
+        return Res;
+    }
+
+    // Monic minimal polynomial of β = Beta(α)
+    // The powers β^0, β^1, ... are coordinate vectors in the basis 1, α, ..., α^(n-1), and the first one that
+    // depends on the ones before it gives the polynomial. Each new power is reduced against the earlier rows with
+    // fraction-free (Bareiss) elimination on integers, with an identity block alongside recording the combination,
+    // so every division is exact and the entries stay minors of the power matrix instead of growing as fractions
+    Poly MinimalPolynomial(const Poly& Beta) const {
+        const size_t N = Degree();
+        const size_t Width = 2 * N + 1;
+        const Poly Element = Reduce(Beta);
+
+        std::vector<std::vector<Integer>> Pivots;
+        std::vector<size_t> PivotCols;
+        std::vector<Integer> Scales;
+
+        Poly Power(T(1), 0);
+        for (size_t k = 0; k <= N; ++k) {
+            if (k > 0) Power = Mul(Power, Element);
+
+            Integer Scale;
+            std::vector<Integer> Row = ToIntegerRow(Power, Width, Scale);
+            Row[N + k] = Integer(1);
+            Scales.push_back(std::move(Scale));
+
+            // Bareiss step j: Row = (p_j * Row - Row[c_j] * Pivot_j) / p_(j-1), the division is exact
+            Integer Previous(1);
+            for (size_t j = 0; j < Pivots.size(); ++j) {
+                const std::vector<Integer>& Pivot = Pivots[j];
+                const Integer& PivotVal = Pivot[PivotCols[j]];
+                const Integer Factor = Row[PivotCols[j]];
+
+                for (size_t c = 0; c < N + k + 1; ++c) {
+                    Integer Val = PivotVal * Row[c];
+                    if (!Factor.IsZero() && !Pivot[c].IsZero()) Val -= Factor * Pivot[c];
+                    Row[c] = Previous == Integer(1) ? std::move(Val) : Integer::DivideExact(std::move(Val), Previous);
+                }
+                Previous = PivotVal;
+            }
+
+            size_t Col = 0;
+            while (Col < N && Row[Col].IsZero()) ++Col;
+
+            if (Col == N) {
+                // Sum of Row[N + i] * Scales[i] * β^i is zero
+                Poly Res;
+                for (size_t i = 0; i <= k; ++i) {
+                    if (!Row[N + i].IsZero()) Res += Poly(T(Row[N + i] * Scales[i], Integer(1)), static_cast<uint32_t>(i));
+                }
+
+                const T Lead = Res.GetLeadingTerm().Cof;
+                Poly Monic;
+                for (const auto& t : Res.GetTerms()) {
+                    Monic += Poly(t.Cof / Lead, t.Exp);
+                }
+                return Monic;
+            }
+
+            Pivots.push_back(std::move(Row));
+            PivotCols.push_back(Col);
+        }
+
+        throw std::runtime_error("Powers of an element of degree n stayed independent past n");
+    }
+
+    // Same polynomial through res_x(Modulus(x), s - Beta(x)), the characteristic polynomial of β, with the
+    // repeated factors removed. Kept as the reference route
+    Poly MinimalPolynomialByResultant(const Poly& Beta) const {
+        using Bivariate = MultiPolynomial<T, 2>;
+
+        const Poly Characteristic = Bivariate::Resultant(
+            Bivariate::FromUnivariate(Modulus, 0), Bivariate::Variable(1) - Bivariate::FromUnivariate(Reduce(Beta), 0), 0
+        );
+        return Poly::GCD(Poly::SquareFreePart(Characteristic), Poly());
+    }
+};
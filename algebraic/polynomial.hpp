@@ -1,16 +1,30 @@
 #pragma once
 
 #include "rational.hpp"
+#include "interval.hpp"
+#include "workpool.hpp"
 
+#include <atomic>
+#include <cmath>
+#include <exception>
 #include <functional>
+#include <map>
+#include <mutex>
+#include <numbers>
+#include <optional>
+#include <span>
+#include <type_traits>
 
 template<typename T = Rational<>>
 class Polynomial {
 private:
     std::string DebugStr = "0";
 
+    // Only read by the Natvis visualizer, and printing every intermediate result dominates release runs
     void _UpdateDebugStr() {
+#ifndef NDEBUG
         DebugStr = ToString(*this);
+#endif
     }
 
 public:
@@ -22,6 +36,495 @@ public:
 private:
     std::vector<Term> Terms;
 
+    // Below this many points (or this degree) plain Horner per point beats building a subproduct tree
+    // Only applies to coefficients of fixed size, see EvaluateMany
+    static constexpr size_t MultipointThreshold = 32;
+    // Estrin levels narrower than this are not worth spreading across a pool
+    static constexpr size_t EstrinParallelThreshold = 64;
+    // Operands shorter than this are multiplied schoolbook, see MulKaratsuba
+    static constexpr size_t KaratsubaThreshold = 32;
+    // Shifts of at most this many coefficients run the quadratic Horner shift, see ShiftDense
+    // Measured crossover with double coefficients, 128 coefficients tie and 256 split 1.6x faster
+    static constexpr size_t TaylorShiftThreshold = 128;
+    // Quotients and divisors at least this long divide through a Newton inverse, see DivRemDenseNewton
+    // Measured with word sized modular coefficients, Newton was 2x slower at 64, even at 2048 and 1.26x faster at 4096
+    static constexpr size_t NewtonDivisionThreshold = 2048;
+
+    // Coefficient types made of a numerator and denominator can run Horner without reducing after every step
+    // A single GCD at the end is far cheaper than one per term
+    static constexpr bool FractionFree = requires(const T& Val) {
+        T(Val.Numerator(), Val.Denominator());
+    };
+
+    // Coefficient types whose values all take the same space, such as double or ModInt, the others grow with the
+    // numbers they hold
+    static constexpr bool FixedSize = std::is_trivially_copyable_v<T>;
+
+    // Coefficient types with a double approximation can settle most signs in interval arithmetic, see SturmEvaluator
+    static constexpr bool Filtered = requires(const T& Val) {
+        { Val.ToDouble() } -> std::convertible_to<double>;
+    };
+
+    struct FilterTerm {
+        uint32_t Exp = 0;
+        Interval<double> Cof;
+    };
+
+    // Every coefficient enclosed in an interval, ToDouble is within a couple of ulps so 4 is a safe margin
+    std::vector<FilterTerm> MakeFilterTerms() const {
+        std::vector<FilterTerm> Res;
+        Res.reserve(Terms.size());
+        for (const Term& t : Terms) {
+            Res.push_back({ t.Exp, Interval<double>::Around(t.Cof.ToDouble(), 4) });
+        }
+        return Res;
+    }
+
+    // Horner over intervals, the result contains the exact value of the polynomial at every point of X
+    static Interval<double> EvaluateFilter(const std::vector<FilterTerm>& Filter, const Interval<double>& X) {
+        if (Filter.empty()) return Interval<double>(0.0);
+
+        auto MulPower = [&](Interval<double>& Val, uint32_t Exp) {
+            for (uint32_t i = 0; i < Exp; ++i) Val *= X;
+        };
+
+        Interval<double> Res = Filter.back().Cof;
+        for (size_t i = Filter.size() - 1; i-- > 0;) {
+            MulPower(Res, Filter[i + 1].Exp - Filter[i].Exp);
+            Res += Filter[i].Cof;
+        }
+        MulPower(Res, Filter.front().Exp);
+
+        return Res;
+    }
+    // Same as EvaluateFilter(MakeFilterTerms(), X), enclosing each coefficient as it is reached, for one-shot signs
+    Interval<double> EvaluateFilter(const Interval<double>& X) const {
+        if (Terms.empty()) return Interval<double>(0.0);
+
+        auto MulPower = [&](Interval<double>& Val, uint32_t Exp) {
+            for (uint32_t i = 0; i < Exp; ++i) Val *= X;
+        };
+
+        Interval<double> Res = Interval<double>::Around(Terms.back().Cof.ToDouble(), 4);
+        for (size_t i = Terms.size() - 1; i-- > 0;) {
+            MulPower(Res, Terms[i + 1].Exp - Terms[i].Exp);
+            Res += Interval<double>::Around(Terms[i].Cof.ToDouble(), 4);
+        }
+        MulPower(Res, Terms.front().Exp);
+
+        return Res;
+    }
+
+    // Horner on the unreduced numerator and denominator, see EvaluateWithPowers
+    auto EvaluateFractionFree(const std::vector<T>& Powers) const {
+        auto Num = Terms.back().Cof.Numerator();
+        auto Den = Terms.back().Cof.Denominator();
+
+        auto MulPower = [&](uint32_t Exp) {
+            if (Exp == 0) return;
+            if (Exp < Powers.size()) {
+                Num *= Powers[Exp].Numerator();
+                Den *= Powers[Exp].Denominator();
+            } else {
+                const T Power = T::Pow(Powers[1], Exp);
+                Num *= Power.Numerator();
+                Den *= Power.Denominator();
+            }
+        };
+
+        for (size_t i = Terms.size() - 1; i-- > 0;) {
+            MulPower(Terms[i + 1].Exp - Terms[i].Exp);
+
+            const T& Cof = Terms[i].Cof;
+            if (Cof.Denominator() == 1) {
+                Num += Cof.Numerator() * Den;
+            } else {
+                Num = Num * Cof.Denominator() + Cof.Numerator() * Den;
+                Den *= Cof.Denominator();
+            }
+        }
+        MulPower(Terms.front().Exp);
+
+        return std::make_pair(std::move(Num), std::move(Den));
+    }
+
+    // Sums built with += may be left unreduced by fraction types, this brings them back to lowest terms
+    static void ReduceCof(T& Val) {
+        if constexpr (FractionFree) {
+            Val = T(Val.Numerator(), Val.Denominator());
+        }
+    }
+
+    // Dense coefficient kernels, index i holds the coefficient of x^i and there are no trailing zeros
+    // Fractions are brought to a common denominator first, so the inner loops only add and multiply integers
+    // and every coefficient of the result is reduced exactly once
+    static std::vector<T> MulDense(const std::vector<T>& LHS, const std::vector<T>& RHS) {
+        if (LHS.empty() || RHS.empty()) return {};
+
+        if constexpr (FractionFree) {
+            auto [LNums, LDen] = ToIntegerDense(LHS);
+            auto [RNums, RDen] = ToIntegerDense(RHS);
+            return FromIntegerDense(MulKaratsuba<decltype(LDen)>(LNums, RNums), LDen * RDen);
+        } else {
+            std::vector<T> Res = MulKaratsuba<T>(LHS, RHS);
+            while (!Res.empty() && Res.back().IsZero()) Res.pop_back();
+            return Res;
+        }
+    }
+
+    // Cofs[i] = Nums[i] / Den with Den the least common denominator
+    static auto ToIntegerDense(const std::vector<T>& Cofs) {
+        using Integer = decltype(Cofs[0].Numerator());
+
+        Integer Den(1);
+        for (const T& Cof : Cofs) {
+            const Integer CofDen = Cof.Denominator();
+            if (CofDen != Integer(1)) {
+                Den = Den / Integer::GCD(Den, CofDen) * CofDen;
+            }
+        }
+
+        std::vector<Integer> Nums;
+        Nums.reserve(Cofs.size());
+        for (const T& Cof : Cofs) {
+            Nums.push_back(Cof.Numerator() * (Den / Cof.Denominator()));
+        }
+        return std::make_pair(std::move(Nums), std::move(Den));
+    }
+    template<typename Integer>
+    static std::vector<T> FromIntegerDense(const std::vector<Integer>& Nums, const Integer& Den) {
+        std::vector<T> Res;
+        Res.reserve(Nums.size());
+        for (const Integer& Num : Nums) {
+            Res.push_back(Num.IsZero() ? T(0) : T(Num, Den));
+        }
+        while (!Res.empty() && Res.back().IsZero()) Res.pop_back();
+        return Res;
+    }
+
+    // Goertzel's recurrence over dense coefficients, see EvaluateComplex
+    template<typename C>
+    static C Goertzel(const std::vector<T>& Cofs, const C& Point) {
+        if (Cofs.empty()) return C(T(0), T(0));
+
+        const T Trace = Point.Real + Point.Real;
+        const T Norm = Point.Real * Point.Real + Point.Imag * Point.Imag;
+
+        T Prior(0), Current(0);
+        for (size_t k = Cofs.size(); k-- > 1;) {
+            T Next = Cofs[k] + Trace * Current - Norm * Prior;
+            Prior = std::move(Current);
+            Current = std::move(Next);
+        }
+        // Current is s_1 and Prior is s_2, s_0 - conj(z) s_1 = a_0 + z s_1 - n s_2
+        return C(Cofs[0] + Point.Real * Current - Norm * Prior, Point.Imag * Current);
+    }
+    // Same recurrence on integers. With a_k = Nums[k] / Den and z = (X + iY) / D, S_k = s_k Den D^(deg-k) is an integer:
+    // S_k = Nums[k] D^(deg-k) + 2X S_(k+1) - (X^2 + Y^2) S_(k+2)
+    // and P(z) = (Nums[0] D^deg + X S_1 - (X^2 + Y^2) S_2 + i Y S_1) / (Den D^deg)
+    template<typename C, typename Integer>
+    static C GoertzelFractionFree(const std::vector<Integer>& Nums, const Integer& Den, const C& Point) {
+        if (Nums.empty()) return C(T(0), T(0));
+
+        const Integer RealDen = Point.Real.Denominator();
+        const Integer ImagDen = Point.Imag.Denominator();
+        const Integer D = RealDen == ImagDen ? RealDen : RealDen / Integer::GCD(RealDen, ImagDen) * ImagDen;
+        const Integer X = Point.Real.Numerator() * (D / RealDen);
+        const Integer Y = Point.Imag.Numerator() * (D / ImagDen);
+        const Integer Trace = X + X;
+        const Integer Norm = X * X + Y * Y;
+        const bool Whole = D == Integer(1);
+
+        Integer Prior(0), Current(0);
+        Integer Scale(1);
+        for (size_t k = Nums.size(); k-- > 1;) {
+            Integer Next = Whole ? Nums[k] : Nums[k] * Scale;
+            if (!Current.IsZero()) Next += Trace * Current;
+            if (!Prior.IsZero()) Next -= Norm * Prior;
+            Prior = std::move(Current);
+            Current = std::move(Next);
+            if (!Whole) Scale *= D;
+        }
+
+        Integer RealNum = Whole ? Nums[0] : Nums[0] * Scale;
+        if (!Current.IsZero()) RealNum += X * Current;
+        if (!Prior.IsZero()) RealNum -= Norm * Prior;
+        const Integer ResDen = Den * Scale;
+        return C(T(RealNum, ResDen), T(Y * Current, ResDen));
+    }
+
+    // Res[Offset + i] += Part[i]
+    template<typename C>
+    static void AddDenseAt(std::vector<C>& Res, const std::vector<C>& Part, size_t Offset) {
+        for (size_t i = 0; i < Part.size(); ++i) {
+            Res[Offset + i] += Part[i];
+        }
+    }
+
+    // Product of two dense coefficient vectors over any ring C, trailing zeros are kept
+    // Above KaratsubaThreshold both operands are cut in half and the product takes three half size
+    // products instead of four, (L0 + L1 x^h)(R0 + R1 x^h) = Z0 + ((L0 + L1)(R0 + R1) - Z0 - Z2) x^h + Z2 x^2h
+    template<typename C>
+    static std::vector<C> MulKaratsuba(std::span<const C> LHS, std::span<const C> RHS) {
+        if (LHS.empty() || RHS.empty()) return {};
+        if (LHS.size() < RHS.size()) std::swap(LHS, RHS);
+
+        std::vector<C> Res(LHS.size() + RHS.size() - 1, C(0));
+
+        if (RHS.size() < KaratsubaThreshold) {
+            for (size_t i = 0; i < LHS.size(); ++i) {
+                if (LHS[i].IsZero()) continue;
+                for (size_t j = 0; j < RHS.size(); ++j) {
+                    Res[i + j] += LHS[i] * RHS[j];
+                }
+            }
+            return Res;
+        }
+
+        const size_t Half = LHS.size() / 2;
+
+        // Lopsided operands, cut the long one into pieces as long as the short one
+        if (RHS.size() <= Half) {
+            for (size_t Start = 0; Start < LHS.size(); Start += RHS.size()) {
+                const size_t Len = std::min(RHS.size(), LHS.size() - Start);
+                AddDenseAt(Res, MulKaratsuba<C>(LHS.subspan(Start, Len), RHS), Start);
+            }
+            return Res;
+        }
+
+        const std::span<const C> L0 = LHS.first(Half), L1 = LHS.subspan(Half);
+        const std::span<const C> R0 = RHS.first(Half), R1 = RHS.subspan(Half);
+
+        std::vector<C> Z0 = MulKaratsuba<C>(L0, R0);
+        std::vector<C> Z2 = MulKaratsuba<C>(L1, R1);
+
+        // L1 is never shorter than L0, R1 can be
+        std::vector<C> LSum(L1.begin(), L1.end());
+        std::vector<C> RSum(R1.begin(), R1.end());
+        RSum.resize(std::max(R1.size(), Half), C(0));
+        for (size_t i = 0; i < Half; ++i) {
+            LSum[i] += L0[i];
+            RSum[i] += R0[i];
+        }
+
+        std::vector<C> Z1 = MulKaratsuba<C>(LSum, RSum);
+        for (size_t i = 0; i < Z0.size(); ++i) Z1[i] -= Z0[i];
+        for (size_t i = 0; i < Z2.size(); ++i) Z1[i] -= Z2[i];
+
+        AddDenseAt(Res, Z0, 0);
+        AddDenseAt(Res, Z1, Half);
+        AddDenseAt(Res, Z2, 2 * Half);
+        return Res;
+    }
+
+    // Cofs becomes the coefficients of P(x + Shift), where P has the coefficients Cofs
+    // Short inputs take the quadratic Horner shift, longer ones split P = Lo + x^m Hi with m a power of two,
+    // so P(x + a) = Lo(x + a) + (x + a)^m Hi(x + a), and the powers (x + a)^(2^k) are built once by squaring
+    // Only pays off when multiplying coefficients costs the same regardless of their size, see TaylorShift
+    template<typename C>
+    static void ShiftDense(std::vector<C>& Cofs, const C& Shift) {
+        if (Cofs.size() <= TaylorShiftThreshold) {
+            ShiftDenseHorner(Cofs, Shift);
+            return;
+        }
+
+        std::vector<std::vector<C>> Binomials { { Shift, C(1) } };
+        while ((size_t(1) << Binomials.size()) < Cofs.size()) {
+            Binomials.push_back(MulKaratsuba<C>(Binomials.back(), Binomials.back()));
+        }
+
+        Cofs = ShiftDenseSplit<C>(Cofs, Shift, Binomials);
+    }
+    template<typename C>
+    static void ShiftDenseHorner(std::vector<C>& Cofs, const C& Shift) {
+        const size_t Size = Cofs.size();
+        for (size_t i = 0; i + 1 < Size; ++i) {
+            for (size_t j = Size - 1; j-- > i;) {
+                Cofs[j] += Shift * Cofs[j + 1];
+            }
+        }
+    }
+    // Binomials[k] holds (x + Shift)^(2^k)
+    template<typename C>
+    static std::vector<C> ShiftDenseSplit(std::span<const C> Cofs, const C& Shift, const std::vector<std::vector<C>>& Binomials) {
+        if (Cofs.size() <= TaylorShiftThreshold) {
+            std::vector<C> Res(Cofs.begin(), Cofs.end());
+            ShiftDenseHorner(Res, Shift);
+            return Res;
+        }
+
+        size_t Level = 0;
+        while ((size_t(2) << Level) < Cofs.size()) ++Level;
+        const size_t Split = size_t(1) << Level;
+
+        std::vector<C> Res = ShiftDenseSplit<C>(Cofs.first(Split), Shift, Binomials);
+        Res.resize(Cofs.size(), C(0));
+
+        const std::vector<C> Hi = ShiftDenseSplit<C>(Cofs.subspan(Split), Shift, Binomials);
+        AddDenseAt(Res, MulKaratsuba<C>(Binomials[Level], Hi), 0);
+        return Res;
+    }
+    // Classical remainder of Num / Den, Den must not be empty
+    static std::vector<T> RemDense(std::vector<T> Num, const std::vector<T>& Den) {
+        const size_t DenDegree = Den.size() - 1;
+        const bool Monic = (Den.back() - T(1)).IsZero();
+
+        for (size_t i = Num.size(); i-- > DenDegree;) {
+            if (Num[i].IsZero()) continue;
+
+            const T Factor = Monic ? Num[i] : Num[i] / Den.back();
+            for (size_t j = 0; j < DenDegree; ++j) {
+                Num[i - DenDegree + j] -= Factor * Den[j];
+            }
+        }
+
+        Num.resize(std::min(Num.size(), DenDegree));
+        while (!Num.empty() && Num.back().IsZero()) Num.pop_back();
+        return Num;
+    }
+
+    // Classical division in place, afterwards Num[0, d) holds the remainder and Num[d, ...) the quotient,
+    // with d = Den.size() - 1, so nothing is allocated besides what the coefficient arithmetic itself needs
+    template<typename C>
+    static void DivRemDenseInPlace(std::vector<C>& Num, std::span<const C> Den) {
+        const size_t DenDegree = Den.size() - 1;
+        const C& Lead = Den.back();
+
+        for (size_t i = Num.size(); i-- > DenDegree;) {
+            if (Num[i].IsZero()) continue;
+
+            Num[i] = Num[i] / Lead;
+            for (size_t j = 0; j < DenDegree; ++j) {
+                Num[i - DenDegree + j] -= Num[i] * Den[j];
+            }
+        }
+    }
+
+    // Pseudo-division over the integers in place, Lead^k Num = Q Den + R with k = Num.size() - Den.size() + 1
+    // Same layout as DivRemDenseInPlace, the true quotient entry at i is Num[i] / Lead^(Num.size() - i)
+    // and the true remainder is R / Lead^k, so no fraction is formed until the caller reduces each entry once
+    template<typename C>
+    static void PseudoDivRemDenseInPlace(std::vector<C>& Num, std::span<const C> Den) {
+        const size_t DenDegree = Den.size() - 1;
+        const C& Lead = Den.back();
+        const bool Monic = Lead == C(1);
+
+        for (size_t i = Num.size(); i-- > DenDegree;) {
+            if (!Monic) {
+                for (size_t j = 0; j < i; ++j) {
+                    if (!Num[j].IsZero()) Num[j] *= Lead;
+                }
+            }
+            if (Num[i].IsZero()) continue;
+
+            for (size_t j = 0; j < DenDegree; ++j) {
+                Num[i - DenDegree + j] -= Num[i] * Den[j];
+            }
+        }
+    }
+
+    // The first Len coefficients of the power series 1 / F, F[0] must not be zero
+    // Each Newton step doubles the number of correct coefficients, G <- G (2 - F G) mod x^2k
+    template<typename C>
+    static std::vector<C> InverseSeries(std::span<const C> F, size_t Len) {
+        std::vector<C> G { C(1) / F[0] };
+
+        for (size_t Done = 1; Done < Len;) {
+            Done = std::min(2 * Done, Len);
+
+            std::vector<C> Err = MulKaratsuba<C>(F.first(std::min(F.size(), Done)), G);
+            Err.resize(Done, C(0));
+            for (C& Val : Err) Val = C(0) - Val;
+            Err[0] += C(2);
+
+            G = MulKaratsuba<C>(G, Err);
+            G.resize(Done, C(0));
+        }
+        return G;
+    }
+
+    // Division through the reversed polynomials, rev(Q) = rev(Num) / rev(Den) mod x^(m - n + 1) with the inverse
+    // from InverseSeries, then R = Num - Q Den, costing a few products instead of (m - n) n multiply-adds
+    // Writes the same layout as DivRemDenseInPlace
+    template<typename C>
+    static void DivRemDenseNewton(std::vector<C>& Num, std::span<const C> Den) {
+        const size_t DenDegree = Den.size() - 1;
+        const size_t QuotLen = Num.size() - DenDegree;
+
+        const std::vector<C> RevDen(Den.rbegin(), Den.rend());
+        const std::vector<C> RevNum(Num.rbegin(), Num.rbegin() + QuotLen);
+
+        std::vector<C> RevQuot = MulKaratsuba<C>(RevNum, InverseSeries<C>(RevDen, QuotLen));
+        RevQuot.resize(QuotLen, C(0));
+        const std::vector<C> Quot(RevQuot.rbegin(), RevQuot.rend());
+
+        const std::vector<C> Prod = MulKaratsuba<C>(Quot, Den);
+        for (size_t i = 0; i < DenDegree; ++i) {
+            Num[i] -= Prod[i];
+        }
+        std::copy(Quot.begin(), Quot.end(), Num.begin() + DenDegree);
+    }
+
+    // ApplyRemainder for exact fractions, with N = Num / NumDen and D = Den / DenDen over the integers
+    // N / D = (DenDen / NumDen) Num / Den, and the remainder is the integer remainder over NumDen
+    void ApplyRemainderPseudo(const Polynomial& Divisor, Polynomial& OutQuotient) {
+        auto [Num, NumDen] = ToIntegerDense(ToDense());
+        auto [Den, DenDen] = ToIntegerDense(Divisor.ToDense());
+        using Integer = decltype(NumDen);
+
+        PseudoDivRemDenseInPlace<Integer>(Num, Den);
+
+        const size_t DenDegree = Den.size() - 1;
+        const size_t QuotLen = Num.size() - DenDegree;
+        std::vector<Integer> LeadPowers { Integer(1) };
+        if (Den.back() != Integer(1)) {
+            for (size_t i = 1; i <= QuotLen; ++i) LeadPowers.push_back(LeadPowers.back() * Den.back());
+        }
+        auto LeadPower = [&](size_t Exp) -> const Integer& {
+            return LeadPowers[std::min(Exp, LeadPowers.size() - 1)];
+        };
+
+        std::vector<T> Quot, Rem;
+        for (size_t i = 0; i < DenDegree; ++i) {
+            Rem.push_back(Num[i].IsZero() ? T(0) : T(Num[i], LeadPower(QuotLen) * NumDen));
+        }
+        for (size_t i = DenDegree; i < Num.size(); ++i) {
+            Quot.push_back(Num[i].IsZero() ? T(0) : T(Num[i] * DenDen, LeadPower(Num.size() - i) * NumDen));
+        }
+
+        OutQuotient = FromDense(Quot);
+        *this = FromDense(Rem);
+    }
+
+    void EvaluateSubproductTree(const std::vector<T>& Points, size_t Begin, size_t End, std::vector<T>& Out) const {
+        // Tree[0] holds (x - p) for every point, each level above holds the pairwise products of the one below
+        std::vector<std::vector<std::vector<T>>> Tree(1);
+        for (size_t i = Begin; i < End; ++i) {
+            Tree[0].push_back({ -Points[i], T(1) });
+        }
+        while (Tree.back().size() > 1) {
+            const std::vector<std::vector<T>>& Below = Tree.back();
+            std::vector<std::vector<T>> Above;
+            for (size_t i = 0; i < Below.size(); i += 2) {
+                Above.push_back(i + 1 < Below.size() ? MulDense(Below[i], Below[i + 1]) : Below[i]);
+            }
+            Tree.push_back(std::move(Above));
+        }
+
+        std::vector<std::vector<T>> Rems { RemDense(ToDense(), Tree.back()[0]) };
+        for (size_t Level = Tree.size() - 1; Level-- > 0;) {
+            std::vector<std::vector<T>> Next;
+            for (size_t i = 0; i < Tree[Level].size(); ++i) {
+                Next.push_back(RemDense(Rems[i / 2], Tree[Level][i]));
+            }
+            Rems = std::move(Next);
+        }
+
+        for (size_t i = Begin; i < End; ++i) {
+            Out[i] = Rems[i - Begin].empty() ? T(0) : Rems[i - Begin][0];
+        }
+    }
+
     void normalize() {
         Terms.erase(
             std::remove_if(Terms.begin(), Terms.end(),
@@ -64,6 +567,10 @@ public:
         }
         return T { 0 };
     }
+    // Nonzero terms in increasing order of exponent
+    const std::vector<Term>& GetTerms() const {
+        return Terms;
+    }
     Term GetLeadingTerm() const {
         return Terms.empty() ? Term { } : Terms.back();
     }
@@ -76,31 +583,33 @@ public:
 
     // Set this value to be the remainder of ((*this) / Divisor)
     // Store the quotient in OutQuotient
+    // Runs on dense coefficients, exact fractions through integer pseudo-division and everything else classically,
+    // or through a Newton inverse once both the quotient and the divisor are long
+    // Classical division of fractions pays a GCD per multiply-add and lost to pseudo-division at every degree tried
     void ApplyRemainder(const Polynomial Divisor, Polynomial& OutQuotient) {
         if (Divisor.IsZero()) throw std::runtime_error("Polynomial division has zero quotient");
 
-        const Term DivisorLeading = Divisor.GetLeadingTerm();
-
         OutQuotient = Polynomial { };
-        
-        while (!IsZero()) {
-            const Term LeadingTerm = GetLeadingTerm();
+        if (IsZero() || Degree() < Divisor.Degree()) return;
 
-            if (DivisorLeading.Exp > LeadingTerm.Exp) {
-                break;
-            }
-
-            const Polynomial Factor {
-                LeadingTerm.Cof / DivisorLeading.Cof,
-                LeadingTerm.Exp - DivisorLeading.Exp
-            };
-
-            OutQuotient += Factor;
+        if constexpr (FractionFree) {
+            ApplyRemainderPseudo(Divisor, OutQuotient);
+            return;
+        }
 
-            const Polynomial Tmp = Divisor * Factor;
+        const size_t DenDegree = Divisor.Degree();
+        std::vector<T> Num = ToDense();
+        const std::vector<T> Den = Divisor.ToDense();
 
-            (*this) -= Tmp;
+        if (Num.size() - DenDegree >= NewtonDivisionThreshold && DenDegree >= NewtonDivisionThreshold) {
+            DivRemDenseNewton<T>(Num, Den);
+        } else {
+            DivRemDenseInPlace<T>(Num, Den);
         }
+
+        OutQuotient = FromDense(std::vector<T>(Num.begin() + DenDegree, Num.end()));
+        Num.resize(DenDegree);
+        *this = FromDense(Num);
     }
 
     // Set this value to be the Nth derivative of itself
@@ -126,15 +635,255 @@ public:
     }
 
     T Evaluate(const T& Value) const {
-        T Res;
+        return EvaluateWithPowers(MakePowers(Value, MaxGap()));
+    }
+
+    // Estrin's scheme, coefficients are combined in pairs with x, then pairs of those with x^2, x^4, ...
+    // Every combination on a level is independent, so with a Pool the wide levels are spread across workers
+    T EvaluateEstrin(const T& Value, WorkPool* Pool = nullptr) const {
+        std::vector<T> Level = ToDense();
+        if (Level.empty()) return T(0);
+
+        T Power = Value;
+        while (Level.size() > 1) {
+            std::vector<T> Next((Level.size() + 1) / 2);
+
+            auto Combine = [&](size_t i) {
+                Next[i] = Level[2 * i];
+                if (2 * i + 1 < Level.size()) {
+                    Next[i] += Level[2 * i + 1] * Power;
+                }
+            };
+
+            if (Pool && Next.size() >= EstrinParallelThreshold) {
+                Pool->ForEach(0, Next.size(), Combine);
+            } else {
+                for (size_t i = 0; i < Next.size(); ++i) Combine(i);
+            }
+
+            Level = std::move(Next);
+            if (Level.size() > 1) Power *= Power;
+        }
+
+        return Level[0];
+    }
+
+    // Evaluate at every point, Out[i] = P(Points[i])
+    // Large batches are split into blocks of about Degree() points, and each block goes through a subproduct tree:
+    // P is reduced modulo the product of (x - p) over the block, then down the tree to the single points
+    // Only fixed size coefficients take the tree. With exact numbers, fractions or Complex<Rational> alike, the tree
+    // products carry coefficients about Degree() times the size of a point and RemDense is quadratic anyway, so per
+    // point Horner measured 4x to 300x faster
+    // Blocks are independent, so with a Pool they are evaluated concurrently
+    std::vector<T> EvaluateMany(const std::vector<T>& Points, WorkPool* Pool = nullptr) const {
+        std::vector<T> Out(Points.size());
+
+        const bool UseTree = FixedSize && Points.size() >= MultipointThreshold && Degree() >= MultipointThreshold;
+        const size_t BlockSize = UseTree ? std::max<size_t>(MultipointThreshold, Degree() + 1) : 64;
+        const size_t NumBlocks = (Points.size() + BlockSize - 1) / BlockSize;
+
+        auto EvaluateBlock = [&](size_t Block) {
+            const size_t Begin = Block * BlockSize;
+            const size_t End = std::min(Points.size(), Begin + BlockSize);
+
+            if (UseTree) {
+                EvaluateSubproductTree(Points, Begin, End, Out);
+            } else {
+                const uint32_t Gap = MaxGap();
+                for (size_t i = Begin; i < End; ++i) {
+                    Out[i] = EvaluateWithPowers(MakePowers(Points[i], Gap));
+                }
+            }
+        };
+
+        if (Pool && NumBlocks > 1) {
+            Pool->ForEach(0, NumBlocks, EvaluateBlock);
+        } else {
+            for (size_t i = 0; i < NumBlocks; ++i) EvaluateBlock(i);
+        }
 
+        return Out;
+    }
+
+    // P at a complex point, for real coefficients. C is any complex type with T parts Real and Imag
+    // z is a root of x^2 - tx + n with t = 2 Re z and n = |z|^2, so Horner on that quadratic, Goertzel's recurrence
+    // s_k = a_k + t s_(k+1) - n s_(k+2), needs two real products per coefficient instead of a complex one, and
+    // P(z) = s_0 - conj(z) s_1. Fractions run the recurrence on integers and are reduced once at the end
+    // Complex coefficients don't need this, Polynomial<Complex<T>>::Evaluate and EvaluateMany already work
+    template<typename C>
+    C EvaluateComplex(const C& Point) const {
+        if constexpr (FractionFree) {
+            const auto [Nums, Den] = ToIntegerDense(ToDense());
+            return GoertzelFractionFree<C>(Nums, Den, Point);
+        } else {
+            return Goertzel<C>(ToDense(), Point);
+        }
+    }
+
+    // EvaluateComplex at every point, the coefficients are brought to integers once for the whole batch
+    template<typename C>
+    std::vector<C> EvaluateComplexMany(const std::vector<C>& Points, WorkPool* Pool = nullptr) const {
+        std::vector<C> Out(Points.size());
+        const std::vector<T> Cofs = ToDense();
+
+        auto Run = [&](auto&& EvaluateOne) {
+            constexpr size_t BlockSize = 64;
+            const size_t NumBlocks = (Points.size() + BlockSize - 1) / BlockSize;
+            auto EvaluateBlock = [&](size_t Block) {
+                const size_t End = std::min(Points.size(), (Block + 1) * BlockSize);
+                for (size_t i = Block * BlockSize; i < End; ++i) Out[i] = EvaluateOne(Points[i]);
+            };
+
+            if (Pool && NumBlocks > 1) {
+                Pool->ForEach(0, NumBlocks, EvaluateBlock);
+            } else {
+                for (size_t i = 0; i < NumBlocks; ++i) EvaluateBlock(i);
+            }
+        };
+
+        if constexpr (FractionFree) {
+            const auto [Nums, Den] = ToIntegerDense(Cofs);
+            Run([&](const C& Point) { return GoertzelFractionFree<C>(Nums, Den, Point); });
+        } else {
+            Run([&](const C& Point) { return Goertzel<C>(Cofs, Point); });
+        }
+        return Out;
+    }
+
+    // P(w^k) for k < N with w = e^(2πi/N), the DFT of the coefficients, for spectral checks such as
+    // P(w^k) Q(w^k) = (PQ)(w^k). Points are the nearest doubles to the roots, exact at quarter turns, and taken in
+    // conjugate pairs, so only the upper half is evaluated and P(conj z) = conj P(z) gives the rest
+    template<typename C>
+    std::vector<C> EvaluateRootsOfUnity(uint32_t N, WorkPool* Pool = nullptr) const {
+        if (N == 0) throw std::runtime_error("Need at least one root of unity");
+
+        std::vector<C> Points;
+        for (uint32_t k = 0; k <= N / 2; ++k) {
+            if (4 * uint64_t(k) % N == 0) {
+                const uint64_t Quarter = 4 * uint64_t(k) / N;
+                Points.push_back(C(T(Quarter == 0 ? 1 : (Quarter == 2 ? -1 : 0)), T(Quarter == 1 ? 1 : 0)));
+            } else {
+                const double Angle = 2 * std::numbers::pi * k / N;
+                Points.push_back(C(T(std::cos(Angle)), T(std::sin(Angle))));
+            }
+        }
+
+        std::vector<C> Res = EvaluateComplexMany(Points, Pool);
+        for (uint32_t k = N / 2 + 1; k < N; ++k) {
+            C Mirror = Res[N - k];
+            Mirror.Imag = -Mirror.Imag;
+            Res.push_back(std::move(Mirror));
+        }
+        return Res;
+    }
+
+    // Coefficients indexed by exponent, with zeros filled in
+    std::vector<T> ToDense() const {
+        std::vector<T> Res;
+        if (IsZero()) return Res;
+
+        Res.resize(Degree() + 1, T(0));
         for (const Term& t : Terms) {
-            Res += t.Cof * T::Pow(Value, t.Exp);
+            Res[t.Exp] = t.Cof;
+        }
+        return Res;
+    }
+    // Terms must have increasing exponents and nonzero coefficients, as GetTerms returns them
+    static Polynomial FromTerms(std::vector<Term> InTerms) {
+        for (size_t i = 0; i < InTerms.size(); ++i) {
+            if (InTerms[i].Cof.IsZero()) throw std::runtime_error("Zero coefficient in term list");
+            if (i > 0 && InTerms[i].Exp <= InTerms[i - 1].Exp) throw std::runtime_error("Term exponents must increase");
+        }
+
+        Polynomial Res;
+        Res.Terms = std::move(InTerms);
+        Res._UpdateDebugStr();
+        return Res;
+    }
+    static Polynomial FromDense(const std::vector<T>& Cofs) {
+        Polynomial Res;
+        for (uint32_t i = 0; i < Cofs.size(); ++i) {
+            if (!Cofs[i].IsZero()) {
+                Res.Terms.push_back({ i, Cofs[i] });
+            }
         }
-        
+        Res._UpdateDebugStr();
         return Res;
     }
 
+    // Powers[i] = Value^i for i <= MaxPower, shared between evaluations of several polynomials at the same point
+    // Large gaps in very sparse polynomials fall back to T::Pow, so the table is capped
+    static std::vector<T> MakePowers(const T& Value, uint32_t MaxPower) {
+        MaxPower = std::clamp<uint32_t>(MaxPower, 1, 64);
+
+        std::vector<T> Powers;
+        Powers.reserve(MaxPower + 1);
+        Powers.push_back(T(1));
+        for (uint32_t i = 1; i <= MaxPower; ++i) {
+            Powers.push_back(i == 1 ? Value : Powers.back() * Value);
+        }
+        return Powers;
+    }
+
+    // Largest power of the evaluation point that EvaluateWithPowers asks for, at least 1
+    uint32_t MaxGap() const {
+        uint32_t Res = 1;
+        uint32_t Prior = 0;
+        for (const Term& t : Terms) {
+            Res = std::max(Res, t.Exp - Prior);
+            Prior = t.Exp;
+        }
+        return Res;
+    }
+    static uint32_t MaxPowerNeeded(const std::vector<Polynomial>& Polys) {
+        uint32_t Res = 1;
+        for (const Polynomial& Poly : Polys) {
+            Res = std::max(Res, Poly.MaxGap());
+        }
+        return Res;
+    }
+
+    // Horner evaluation, walking the terms from the top and multiplying by the gap between exponents
+    T EvaluateWithPowers(const std::vector<T>& Powers) const {
+        if (IsZero()) return T(0);
+
+        if constexpr (FractionFree) {
+            auto [Num, Den] = EvaluateFractionFree(Powers);
+            return T(Num, Den);
+        } else {
+            auto MulPower = [&](T& Val, uint32_t Exp) {
+                if (Exp == 0) return;
+                if (Exp < Powers.size()) {
+                    Val *= Powers[Exp];
+                } else {
+                    Val *= T::Pow(Powers[1], Exp);
+                }
+            };
+
+            T Res = Terms.back().Cof;
+            for (size_t i = Terms.size() - 1; i-- > 0;) {
+                MulPower(Res, Terms[i + 1].Exp - Terms[i].Exp);
+                Res += Terms[i].Cof;
+            }
+            MulPower(Res, Terms.front().Exp);
+
+            return Res;
+        }
+    }
+
+    // Sign of the value EvaluateWithPowers would return, as -1, 0 or 1
+    int32_t EvaluateSignWithPowers(const std::vector<T>& Powers) const {
+        if (IsZero()) return 0;
+
+        if constexpr (FractionFree) {
+            // Denominators are kept positive, so the unreduced numerator already has the right sign
+            return EvaluateFractionFree(Powers).first.Sign();
+        } else {
+            const T Val = EvaluateWithPowers(Powers);
+            return Val.IsZero() ? 0 : (Val < 0 ? -1 : 1);
+        }
+    }
+
     static Polynomial Pow(Polynomial Base, uint32_t exp) {
         Polynomial Res = { 1, 0 };
         while (exp > 0) {
@@ -145,11 +894,151 @@ public:
         return Res;
     }
 
+    // P(x + Shift)
+    // Exact fractions are shifted over the integers, with Shift = p / q and D the common denominator of P
+    // D q^n P(x + p / q) = S(q x) where S(x) = sum D c_i q^(n - i) (x + p)^i only has integer coefficients
+    static Polynomial TaylorShift(const Polynomial& P, const T& Shift) {
+        if (P.IsZero() || Shift.IsZero()) return P;
+
+        if constexpr (FractionFree) {
+            auto [Nums, Den] = ToIntegerDense(P.ToDense());
+            using Integer = decltype(Den);
+
+            const Integer ShiftNum = Shift.Numerator();
+            const Integer ShiftDen = Shift.Denominator();
+            const bool Whole = ShiftDen == Integer(1);
+
+            const size_t Degree = Nums.size() - 1;
+            std::vector<Integer> DenPowers(Degree + 1, Integer(1));
+            if (!Whole) {
+                for (size_t i = 1; i <= Degree; ++i) DenPowers[i] = DenPowers[i - 1] * ShiftDen;
+                for (size_t i = 0; i < Degree; ++i) Nums[i] *= DenPowers[Degree - i];
+            }
+
+            // Horner only ever multiplies by the small ShiftNum, while splitting multiplies the grown coefficients
+            // by each other, and with schoolbook BigInt products that measured 1.3x to 5x slower at every size
+            ShiftDenseHorner(Nums, ShiftNum);
+
+            std::vector<T> Cofs;
+            Cofs.reserve(Nums.size());
+            for (size_t i = 0; i <= Degree; ++i) {
+                Cofs.push_back(Nums[i].IsZero() ? T(0) : T(Nums[i], Whole ? Den : Den * DenPowers[Degree - i]));
+            }
+            return FromDense(Cofs);
+        } else {
+            std::vector<T> Cofs = P.ToDense();
+            ShiftDense(Cofs, Shift);
+            while (!Cofs.empty() && Cofs.back().IsZero()) Cofs.pop_back();
+            return FromDense(Cofs);
+        }
+    }
+
     // P ∘ Q
-    static Polynomial Composite(Polynomial P, Polynomial Q) {
+    // A linear Q = b x + c is a Taylor shift by c followed by scaling x by b, anything else runs Horner over
+    // polynomials, Res = Res * Q^gap + Cof, with every distinct power of Q computed once
+    static Polynomial Composite(const Polynomial& P, const Polynomial& Q) {
+        if (P.IsZero()) return P;
+
+        if (Q.Degree() == 0) {
+            return Polynomial(P.Evaluate(Q.GetCof(0)), 0);
+        }
+
+        if (Q.Degree() == 1) {
+            const T Scale = Q.GetCof(1);
+
+            Polynomial Res = TaylorShift(P, Q.GetCof(0));
+            if ((Scale - T(1)).IsZero()) return Res;
+
+            T Factor = T(1);
+            uint32_t FactorExp = 0;
+            for (Term& t : Res.Terms) {
+                for (; FactorExp < t.Exp; ++FactorExp) Factor *= Scale;
+                t.Cof *= Factor;
+            }
+            Res._UpdateDebugStr();
+            return Res;
+        }
+
+        std::map<uint32_t, Polynomial> QPowers;
+        auto MulPower = [&](Polynomial& Val, uint32_t Exp) {
+            if (Exp == 0) return;
+            auto It = QPowers.find(Exp);
+            if (It == QPowers.end()) It = QPowers.emplace(Exp, Pow(Q, Exp)).first;
+            Val *= It->second;
+        };
+
+        Polynomial Res(P.Terms.back().Cof, 0);
+        for (size_t i = P.Terms.size() - 1; i-- > 0;) {
+            MulPower(Res, P.Terms[i + 1].Exp - P.Terms[i].Exp);
+            Res += Polynomial(P.Terms[i].Cof, 0);
+        }
+        MulPower(Res, P.Terms.front().Exp);
+
+        return Res;
+    }
+
+    // Resultant of A and B, zero exactly when they share a root
+    // Euclid on the remainders, res(A, B) = (-1)^(deg A deg B) lc(B)^(deg A - deg R) res(B, R) with R = A mod B
+    static T Resultant(Polynomial A, Polynomial B) {
+        if (A.IsZero() || B.IsZero()) return T(0);
+
+        T Res = T(1);
+        while (B.Degree() > 0) {
+            const uint32_t DegA = A.Degree();
+            const uint32_t DegB = B.Degree();
+
+            A %= B;
+            if (A.IsZero()) return T(0);
+
+            if ((DegA & 1) && (DegB & 1)) Res = -Res;
+            Res *= T::Pow(B.GetLeadingTerm().Cof, DegA - A.Degree());
+
+            std::swap(A, B);
+        }
+
+        return Res * T::Pow(B.GetLeadingTerm().Cof, A.Degree());
+    }
+
+    // Monic greatest common divisor, zero only if both are zero
+    static Polynomial GCD(Polynomial A, Polynomial B) {
+        while (!B.IsZero()) {
+            A %= B;
+            std::swap(A, B);
+        }
+        if (A.IsZero()) return A;
+
+        const T Lead = A.GetLeadingTerm().Cof;
+        for (Term& t : A.Terms) {
+            t.Cof = t.Cof / Lead;
+        }
+        A._UpdateDebugStr();
+        return A;
+    }
+
+    // Same roots as P, each of them simple
+    static Polynomial SquareFreePart(const Polynomial& P) {
+        Polynomial Derivative = P;
+        Derivative.ApplyDerivative(1);
+
+        const Polynomial Common = GCD(P, Derivative);
+        return Common.Degree() == 0 ? P : P / Common;
+    }
+
+    // The polynomial of degree below Points.size() through (Points[i], Values[i]), Points must be distinct
+    // Newton divided differences, then Horner on the Newton form
+    static Polynomial Interpolate(const std::vector<T>& Points, std::vector<T> Values) {
+        if (Points.size() != Values.size()) throw std::runtime_error("Interpolation needs one value per point");
+
+        for (size_t Level = 1; Level < Points.size(); ++Level) {
+            for (size_t i = Points.size() - 1; i >= Level; --i) {
+                Values[i] = (Values[i] - Values[i - 1]) / (Points[i] - Points[i - Level]);
+            }
+        }
+
         Polynomial Res;
-        for (auto &Term : P.Terms) {
-            Res += Polynomial(Term.Cof, 0) * Pow(Q, Term.Exp);
+        for (size_t i = Points.size(); i-- > 0;) {
+            Res *= Polynomial(1, 1) - Polynomial(Points[i], 0);
+            Res += Polynomial(Values[i], 0);
         }
         return Res;
     }
@@ -174,28 +1063,68 @@ public:
         return Res;
     }
 
-    // Returns the number of sign changes, or -1 if the value is a root
+    // Sign of every polynomial in Sturm at Value, in order, as -1, 0 or 1
+    // Powers[i] must hold Value^i, see MakePowers
+    static std::vector<int8_t> EvaluateSigns(const std::vector<Polynomial>& Sturm, const std::vector<T>& Powers) {
+        std::vector<int8_t> Signs;
+        Signs.reserve(Sturm.size());
+
+        for (const Polynomial& Poly : Sturm) {
+            Signs.push_back(static_cast<int8_t>(Poly.EvaluateSignWithPowers(Powers)));
+        }
+
+        return Signs;
+    }
+
+    // Returns the number of sign changes in a sign vector from EvaluateSigns
+    static int32_t CountSignChanges(const std::vector<int8_t>& Signs, bool& OutIsRoot) {
+        OutIsRoot = !Signs.empty() && Signs[0] == 0;
+        int32_t Res = 0;
+
+        int32_t PriorSign = 0;
+        for (const int8_t NewSign : Signs) {
+            if (NewSign == 0) continue;
+            if (PriorSign != 0 && PriorSign != NewSign) {
+                ++Res;
+            }
+            PriorSign = NewSign;
+        }
+
+        return Res;
+    }
+
+    // Returns the number of sign changes of Sturm at Value, OutIsRoot tells whether Value is a root of the first one
+    // One-shot, each sign is counted as it is evaluated, through the interval filter first where there is one and
+    // exactly only when that can't settle it. Callers asking about many points should keep a SturmEvaluator instead
     static int32_t CountSignChanges(const std::vector<Polynomial>& Sturm, const T& Value, bool& OutIsRoot) {
+        std::vector<T> Powers;
+        Interval<double> X(0.0);
+        if constexpr (Filtered) X = Interval<double>::Around(Value.ToDouble(), 4);
+        auto Sign = [&](const Polynomial& Poly) {
+            if constexpr (Filtered) {
+                const int32_t Filter = Poly.EvaluateFilter(X).Sign();
+                if (Filter != 0) return Filter;
+            }
+            if (Powers.empty()) Powers = MakePowers(Value, MaxPowerNeeded(Sturm));
+            return Poly.EvaluateSignWithPowers(Powers);
+        };
+
         OutIsRoot = false;
         int32_t Res = 0;
 
         int32_t PriorSign = 0;
         for (size_t i = 0; i < Sturm.size(); ++i) {
-            T Val = Sturm[i].Evaluate(Value);
-
-            if (Val.IsZero()) {
-                if (i == 0) {
-                    OutIsRoot = true;
-                }
-            } else {
-                int32_t NewSign = Val < 0 ? -1 : 1;
-                if (PriorSign != 0 && PriorSign != NewSign) {
-                    ++Res;
-                }
-                PriorSign = NewSign;
+            const int32_t NewSign = Sign(Sturm[i]);
+            if (NewSign == 0) {
+                if (i == 0) OutIsRoot = true;
+                continue;
             }
+            if (PriorSign != 0 && PriorSign != NewSign) {
+                ++Res;
+            }
+            PriorSign = NewSign;
         }
-        
+
         return Res;
     }
 
@@ -215,31 +1144,293 @@ public:
         return (LowerIsRoot ? 1 : 0) + abs(abs(LowerSignChange) - abs(UpperSignChange));
     }
 
+    // Shrink [A, B] around the root of P inside it until B - A <= MaxError, the root stays enclosed throughout
+    // P must have exactly one root in [A, B], and it must be simple, so P changes sign across it
+    // Abbott's quadratic interval refinement: the secant through the endpoints picks one of N grid cells, and only the
+    // signs at that cell's edges are checked. A hit shrinks the interval by N and squares N, a miss halves log(N),
+    // so convergence is quadratic once the secant is accurate and never worse than bisection otherwise
+    // Returns false, leaving A and B untouched, if P has the same nonzero sign on both ends
+    static bool RefineRoot(const Polynomial& P, T& A, T& B, const T& MaxError) {
+        T ValA = P.Evaluate(A);
+        T ValB = P.Evaluate(B);
+
+        if (ValA.IsZero()) { B = A; return true; }
+        if (ValB.IsZero()) { A = B; return true; }
+
+        const bool NegativeA = ValA < 0;
+        if (NegativeA == (ValB < 0)) return false;
+
+        // Returns true if the root is exactly Point, otherwise narrows [A, B] to the side of Point holding it
+        auto Split = [&](const T& Point) {
+            T Val = P.Evaluate(Point);
+            if (Val.IsZero()) {
+                A = Point;
+                B = Point;
+                return true;
+            }
+            if ((Val < 0) == NegativeA) {
+                A = Point;
+                ValA = std::move(Val);
+            } else {
+                B = Point;
+                ValB = std::move(Val);
+            }
+            return false;
+        };
+
+        uint32_t LogN = 2;
+        while (B - A > MaxError) {
+            if (LogN <= 1) {
+                if (Split((A + B) / 2)) return true;
+                LogN = 2;
+                continue;
+            }
+
+            const T N = T::Pow(T(2), LogN);
+            const T Width = (B - A) / N;
+            const T Index = T((N * ValA / (ValA - ValB)).Round());
+
+            // Check the edges of the cell next to the secant point, on the side the root turns out to be
+            if (Index <= 0) {
+                if (Split(A + Width)) return true;
+            } else if (Index >= N) {
+                if (Split(B - Width)) return true;
+            } else {
+                const T Point = A + Index * Width;
+                if (Split(Point)) return true;
+                if (A == Point) {
+                    if (Split(Point + Width)) return true;
+                } else {
+                    if (Split(Point - Width)) return true;
+                }
+            }
+
+            if (B - A <= Width) {
+                LogN *= 2;
+            } else {
+                LogN /= 2;
+            }
+        }
+
+        return true;
+    }
+
+    // Evaluates a whole Sturm sequence at once and remembers the sign vector of every point it has seen
+    // Bisection shares each midpoint between two children, so half the endpoint evaluations become lookups
+    // Thread safe, evaluation happens outside the lock so concurrent misses on different points don't serialize
+    // When T converts to double every polynomial is first evaluated over intervals, and only the ones whose
+    // enclosure touches zero are evaluated exactly. Away from roots that settles nearly every sign
+    class SturmEvaluator {
+        std::vector<Polynomial> Sturm;
+        uint32_t MaxPower = 0;
+
+        std::vector<std::vector<FilterTerm>> Filters;
+        mutable std::atomic<size_t> FilterHits { 0 };
+        mutable std::atomic<size_t> FilterMisses { 0 };
+
+        // The first polynomial divided by the last (its GCD with its derivative), same roots but all simple
+        // Only root refinement needs it, so the division is put off until then
+        mutable Polynomial SquareFree;
+        mutable std::once_flag SquareFreeOnce;
+
+        mutable std::map<T, std::vector<int8_t>> Cache;
+        mutable std::mutex CacheLock;
+
+        const Polynomial& GetSquareFree() const {
+            std::call_once(SquareFreeOnce, [this] {
+                if (!Sturm.empty()) {
+                    SquareFree = Sturm.back().Degree() == 0 ? Sturm.front() : Sturm.front() / Sturm.back();
+                }
+            });
+            return SquareFree;
+        }
+
+        std::vector<int8_t> EvaluateSigns(const T& Value) const {
+            if constexpr (!Filtered) {
+                return Polynomial::EvaluateSigns(Sturm, MakePowers(Value, MaxPower));
+            } else {
+                const Interval<double> X = Interval<double>::Around(Value.ToDouble(), 4);
+
+                std::vector<int8_t> Res(Sturm.size(), 0);
+                std::vector<T> Powers;
+                for (size_t i = 0; i < Sturm.size(); ++i) {
+                    const int32_t Sign = EvaluateFilter(Filters[i], X).Sign();
+                    if (Sign != 0) {
+                        FilterHits.fetch_add(1, std::memory_order_relaxed);
+                        Res[i] = static_cast<int8_t>(Sign);
+                        continue;
+                    }
+
+                    FilterMisses.fetch_add(1, std::memory_order_relaxed);
+                    if (Powers.empty()) Powers = MakePowers(Value, MaxPower);
+                    Res[i] = static_cast<int8_t>(Sturm[i].EvaluateSignWithPowers(Powers));
+                }
+                return Res;
+            }
+        }
+
+    public:
+        explicit SturmEvaluator(std::vector<Polynomial> InSturm)
+            : Sturm(std::move(InSturm)), MaxPower(MaxPowerNeeded(Sturm))
+        {
+            if constexpr (Filtered) {
+                Filters.reserve(Sturm.size());
+                for (const Polynomial& Poly : Sturm) {
+                    Filters.push_back(Poly.MakeFilterTerms());
+                }
+            }
+        }
+
+        const std::vector<Polynomial>& Sequence() const {
+            return Sturm;
+        }
+
+        // The returned reference stays valid for the lifetime of the evaluator
+        const std::vector<int8_t>& Signs(const T& Value) const {
+            {
+                std::lock_guard Lock(CacheLock);
+                auto It = Cache.find(Value);
+                if (It != Cache.end()) return It->second;
+            }
+
+            std::vector<int8_t> Res = EvaluateSigns(Value);
+
+            std::lock_guard Lock(CacheLock);
+            return Cache.emplace(Value, std::move(Res)).first->second;
+        }
+
+        int32_t CountSignChanges(const T& Value, bool& OutIsRoot) const {
+            return Polynomial::CountSignChanges(Signs(Value), OutIsRoot);
+        }
+
+        int32_t MinNumRootsEnclosed(const T& Lower, const T& Upper) const {
+            if (Lower == Upper) throw std::runtime_error("Region of size 0");
+
+            bool LowerIsRoot, Unused;
+            int32_t LowerSignChange = CountSignChanges(Lower, LowerIsRoot);
+            int32_t UpperSignChange = CountSignChanges(Upper, Unused);
+
+            return (LowerIsRoot ? 1 : 0) + abs(abs(LowerSignChange) - abs(UpperSignChange));
+        }
+
+        // Approximates the single root counted by MinNumRootsEnclosed(Lower, Upper) to within MaxError / 2
+        // Returns nothing if that root is Upper itself, it belongs to the interval starting there
+        std::optional<T> RefineIsolatedRoot(T Lower, T Upper, const T& MaxError) const {
+            const Polynomial& Simple = GetSquareFree();
+            if (Simple.Evaluate(Upper).IsZero() && !Simple.Evaluate(Lower).IsZero()) {
+                return std::nullopt;
+            }
+
+            if (!RefineRoot(Simple, Lower, Upper, MaxError)) {
+                throw std::runtime_error("Isolating interval has no sign change");
+            }
+
+            return (Lower + Upper) / 2;
+        }
+
+        size_t NumCachedPoints() const {
+            std::lock_guard Lock(CacheLock);
+            return Cache.size();
+        }
+
+        // Signs settled by the interval filter and signs that needed exact evaluation, both 0 without a filter
+        size_t NumFilterHits() const {
+            return FilterHits.load();
+        }
+        size_t NumFilterMisses() const {
+            return FilterMisses.load();
+        }
+    };
+
+private:
+    // Intervals holding fewer roots than this are bisected serially by the parallel EvaluateRootsInRange, their
+    // subtrees are too small to pay for queueing a task per node
+    static constexpr int32_t ParallelRootsThreshold = 4;
+
+    // Appends the roots in [A, B) to Roots, halving until each interval holds at most one
+    static void Bisect(const SturmEvaluator& Evaluator, const T& A, const T& B, const T& MaxError, std::vector<T>& Roots) {
+        const int32_t NumRoots = Evaluator.MinNumRootsEnclosed(A, B);
+        if (NumRoots == 0) return;
+        if (NumRoots == 1) {
+            if (auto Root = Evaluator.RefineIsolatedRoot(A, B, MaxError)) {
+                Roots.push_back(std::move(*Root));
+            }
+            return;
+        }
+        const T Mid = (A + B) / 2;
+        Bisect(Evaluator, A, Mid, MaxError, Roots);
+        Bisect(Evaluator, Mid, B, MaxError, Roots);
+    }
+
+public:
     static std::vector<T> EvaluateRootsInRange(
         const std::vector<Polynomial>& Sturm,
         const T& Lower,
         const T& Upper,
         const T& MaxError
     ) {
+        const SturmEvaluator Evaluator(Sturm);
         std::vector<T> Roots;
+        Bisect(Evaluator, Lower, Upper, MaxError, Roots);
+        std::sort(Roots.begin(), Roots.end());
+        return Roots;
+    }
+
+    // Same as above, but independent subintervals are bisected concurrently on Pool
+    // Safe to call from inside a Pool task, e.g. to isolate many polynomials at once
+    static std::vector<T> EvaluateRootsInRange(
+        const std::vector<Polynomial>& Sturm,
+        const T& Lower,
+        const T& Upper,
+        const T& MaxError,
+        WorkPool& Pool
+    ) {
+        const SturmEvaluator Evaluator(Sturm);
+
+        std::vector<T> Roots;
+        std::mutex RootsLock;
+
+        WorkPool::Group Tasks;
 
-        std::function<void(T, T)> Bisect =
+        std::function<void(T, T)> BisectShared =
             [&](T A, T B) {
-                int32_t NumRoots = MinNumRootsEnclosed(Sturm, A, B);
-                if (NumRoots == 0) return;
-                if (NumRoots == 1) {
-                    if ((B - A) <= MaxError)
-                        Roots.push_back((A + B) / 2);
-                    else
-                        Bisect(A, (A + B) / 2), Bisect((A + B) / 2, B);
-                    return;
+                while (true) {
+                    const int32_t NumRoots = Evaluator.MinNumRootsEnclosed(A, B);
+
+                    if (NumRoots == 0) return;
+                    if (NumRoots < ParallelRootsThreshold) {
+                        // The evaluator remembers the endpoints, so counting again in Bisect is a lookup
+                        std::vector<T> Found;
+                        Bisect(Evaluator, A, B, MaxError, Found);
+                        std::lock_guard Lock(RootsLock);
+                        for (T& Root : Found) Roots.push_back(std::move(Root));
+                        return;
+                    }
+
+                    // Hand the upper half to the pool and keep descending into the lower half
+                    T Mid = (A + B) / 2;
+                    Pool.Submit(Tasks, [&BisectShared, Mid, B] { BisectShared(Mid, B); });
+                    B = std::move(Mid);
                 }
-                T Mid = (A + B) / 2;
-                Bisect(A, Mid);
-                Bisect(Mid, B);
             };
 
-        Bisect(Lower, Upper);
+        // Queued tasks hold references into this frame, so they have to drain even when the caller's share throws
+        std::exception_ptr Error;
+        try {
+            BisectShared(Lower, Upper);
+        } catch (...) {
+            Error = std::current_exception();
+        }
+        if (Error) {
+            try {
+                Pool.Wait(Tasks);
+            } catch (...) {
+            }
+            std::rethrow_exception(Error);
+        }
+        Pool.Wait(Tasks);
+
+        // Leaves are fixed by the intervals alone, so sorting makes the output independent of scheduling
         std::sort(Roots.begin(), Roots.end());
         return Roots;
     }
@@ -291,7 +1482,10 @@ public:
             
             if (i == 0) break;
 
-            if (n.Cof < 0) {
+            // Coefficients without an order, such as residues, are always added
+            bool Negative = false;
+            if constexpr (requires { n.Cof < 0; }) Negative = n.Cof < 0;
+            if (Negative) {
                 InvertNextSign = true;
                 Res += " - ";
             } else {
@@ -337,14 +1531,37 @@ public:
         Other += *this;
         return Other;
     }
+    // Mostly filled operands go through the dense kernels, sparse ones multiply term by term and merge
     Polynomial& operator*=(const Polynomial& Other) {
-        Polynomial Result;
-        for (Term const& t : Terms) {
-            for (Term const& o : Other.Terms) {
-                Result += Polynomial(t.Cof * o.Cof, t.Exp + o.Exp);
+        auto MostlyFilled = [](const Polynomial& Poly) {
+            return 2 * Poly.Terms.size() > Poly.Degree();
+        };
+
+        if (IsZero() || Other.IsZero()) {
+            Terms.clear();
+        } else if (MostlyFilled(*this) && MostlyFilled(Other)) {
+            Terms = FromDense(MulDense(ToDense(), Other.ToDense())).Terms;
+        } else {
+            std::vector<Term> Products;
+            Products.reserve(Terms.size() * Other.Terms.size());
+            for (Term const& t : Terms) {
+                for (Term const& o : Other.Terms) {
+                    Products.push_back({ t.Exp + o.Exp, t.Cof * o.Cof });
+                }
+            }
+            std::stable_sort(Products.begin(), Products.end(), [](const Term& L, const Term& R) { return L.Exp < R.Exp; });
+
+            Terms.clear();
+            for (Term& Product : Products) {
+                if (!Terms.empty() && Terms.back().Exp == Product.Exp) {
+                    Terms.back().Cof += Product.Cof;
+                } else {
+                    Terms.push_back(std::move(Product));
+                }
             }
+            for (Term& t : Terms) ReduceCof(t.Cof);
+            normalize();
         }
-        *this = std::move(Result);
         _UpdateDebugStr();
         return *this;
     }
@@ -1,29 +1,336 @@
 #pragma once
 
 #include "polynomial.hpp"
+#include "multipoly.hpp"
 
+#include <memory>
+
+// Real algebraic number, the single root of Expression inside the isolating interval (Min, Max]
+// Expression is square-free, so it changes sign across the interval, but it need not be irreducible.
+// Comparisons swap it for a smaller factor whenever they come across one, and both the interval and the
+// polynomial are only refined as far as a comparison or a print asks for. Min == Max means the value is
+// exactly that rational
 template<typename P = Polynomial<>>
 class PolyVal {
     using T = decltype(P::Term::Cof);
+    using Bivariate = MultiPolynomial<T, 2>;
+
+    mutable P Expression;
+    mutable T Min;
+    mutable T Max;
+
+    // Sturm sequence of Expression, built on first use and shared between copies
+    mutable std::shared_ptr<const typename P::SturmEvaluator> Sturm;
+
+    PolyVal(P InExpression, T InMin, T InMax) : Expression(std::move(InExpression)), Min(std::move(InMin)), Max(std::move(InMax)) { }
+
+    const typename P::SturmEvaluator& GetSturm() const {
+        if (!Sturm) Sturm = std::make_shared<const typename P::SturmEvaluator>(P::MakeSturmSequence(Expression));
+        return *Sturm;
+    }
+
+    void SetExpression(P NewExpression) const {
+        Expression = std::move(NewExpression);
+        Sturm.reset();
+    }
+
+    // Once the value is known exactly there is no reason to keep a larger polynomial around
+    void SetExact(const T& Val) const {
+        Min = Val;
+        Max = Val;
+        SetExpression(P(1, 1) - P(Val, 0));
+    }
+
+    // Number of distinct roots in [Lower, Upper] of the square-free polynomial behind Evaluator
+    static int32_t CountRoots(const typename P::SturmEvaluator& Evaluator, const T& Lower, const T& Upper) {
+        bool LowerIsRoot, Unused;
+        const int32_t LowerChanges = Evaluator.CountSignChanges(Lower, LowerIsRoot);
+        if (Lower == Upper) return LowerIsRoot ? 1 : 0;
+
+        const int32_t UpperChanges = Evaluator.CountSignChanges(Upper, Unused);
+        return LowerChanges - UpperChanges + (LowerIsRoot ? 1 : 0);
+    }
+
+    // Picks the root of Candidate, square-free, that lies in [Lower, Upper] if there is exactly one
+    // Returns false if the interval holds several, so the caller has to narrow it
+    static bool TryIsolate(const P& Candidate, std::shared_ptr<const typename P::SturmEvaluator>& Evaluator,
+                           const T& Lower, const T& Upper, PolyVal& Out) {
+        if (!Evaluator) Evaluator = std::make_shared<const typename P::SturmEvaluator>(P::MakeSturmSequence(Candidate));
+
+        const int32_t Count = CountRoots(*Evaluator, Lower, Upper);
+        if (Count == 0) throw std::runtime_error("Algebraic number lost its root during isolation");
+        if (Count > 1) return false;
+
+        Out = PolyVal(Candidate, Lower, Upper);
+        Out.Sturm = Evaluator;
+        if (Candidate.Evaluate(Upper).IsZero()) {
+            Out.SetExact(Upper);
+        } else if (Candidate.Evaluate(Lower).IsZero()) {
+            Out.SetExact(Lower);
+        }
+        return true;
+    }
+
+    // The value of Op(*this, Other) is a root of Resultant, and lies in the interval Bounds() returns
+    // Narrows both operands until that interval isolates a single root
+    template<typename BoundsFn>
+    PolyVal FromResultant(const PolyVal& Other, const P& Resultant, BoundsFn Bounds) const {
+        const P Candidate = P::SquareFreePart(Resultant);
+        std::shared_ptr<const typename P::SturmEvaluator> Evaluator;
+
+        PolyVal Res;
+        while (true) {
+            auto [Lower, Upper] = Bounds(*this, Other);
+            if (TryIsolate(Candidate, Evaluator, Lower, Upper, Res)) return Res;
+
+            RefineTo(Width() / 2);
+            Other.RefineTo(Other.Width() / 2);
+        }
+    }
 
-    P Expression;
-    T Min;
-    T Max;
-    std::vector<P> Sturm;
 public:
-    static PolyVal Root(uint32_t Root, T Val) {
-        if (Val < 0) {
-            throw std::runtime_error("Can't take root of negative");
-        } else if (Val.IsZero()) {
-            Min = 0;
-            Max = 0;
-        } else {
-            Min = 0;
-            Max = Val;
+    PolyVal() : PolyVal(T(0)) { }
+    PolyVal(T Val) : Expression(P(1, 1) - P(Val, 0)), Min(Val), Max(Val) { }
+    PolyVal(int64_t Val) : PolyVal(T(Val)) { }
+
+    // The single root of Poly inside [Lower, Upper]
+    static PolyVal FromRoot(const P& Poly, const T& Lower, const T& Upper) {
+        if (Poly.IsZero()) throw std::runtime_error("Zero polynomial has no isolated roots");
+        if (Upper < Lower) throw std::runtime_error("Isolating interval is empty");
+
+        std::shared_ptr<const typename P::SturmEvaluator> Evaluator;
+        PolyVal Res;
+        if (!TryIsolate(P::SquareFreePart(Poly), Evaluator, Lower, Upper, Res)) {
+            throw std::runtime_error("Interval holds more than one root");
+        }
+        return Res;
+    }
+
+    // Every real root of Poly in increasing order
+    static std::vector<PolyVal> RealRoots(const P& Poly) {
+        if (Poly.IsZero()) throw std::runtime_error("Zero polynomial has no isolated roots");
+
+        const P Simple = P::SquareFreePart(Poly);
+        auto Evaluator = std::make_shared<const typename P::SturmEvaluator>(P::MakeSturmSequence(Simple));
+
+        // Pending intervals are half-open (Lower, Upper], so a root on a bisection point is counted once
+        T Bound = P::CauchyBounds(Simple) - 1;
+        Bound.ApplyAbs();
+        Bound = Bound + 1;
+        std::vector<std::pair<T, T>> Pending { { -Bound - 1, Bound } };
+        std::vector<PolyVal> Res;
+        while (!Pending.empty()) {
+            auto [Lower, Upper] = Pending.back();
+            Pending.pop_back();
+
+            bool Unused;
+            const int32_t Count = Evaluator->CountSignChanges(Lower, Unused) - Evaluator->CountSignChanges(Upper, Unused);
+            if (Count == 0) continue;
+
+            // TryIsolate counts the closed interval, which only fails if Lower is a root found earlier
+            PolyVal Root;
+            if (Count == 1 && TryIsolate(Simple, Evaluator, Lower, Upper, Root)) {
+                Res.push_back(std::move(Root));
+                continue;
+            }
+
+            const T Mid = (Lower + Upper) / 2;
+            Pending.push_back({ Lower, Mid });
+            Pending.push_back({ Mid, Upper });
+        }
+
+        std::sort(Res.begin(), Res.end());
+        return Res;
+    }
+
+    // Positive real N-th root of Val
+    static PolyVal Root(uint32_t N, T Val) {
+        if (N == 0) throw std::runtime_error("Zeroth root is undefined");
+        if (Val < 0) throw std::runtime_error("Can't take root of negative");
+        if (Val.IsZero()) return PolyVal(T(0));
+
+        // x^N - Val is square-free with one positive root, which is at most max(1, Val)
+        PolyVal Res(P(T(1), N) - P(Val, 0), T(0), Val < 1 ? T(1) : Val);
+        if (Res.Expression.Evaluate(Res.Max).IsZero()) Res.SetExact(Res.Max);
+        return Res;
+    }
+
+    const P& GetExpression() const {
+        return Expression;
+    }
+    bool IsExact() const {
+        return Min == Max;
+    }
+    T Lower() const {
+        return Min;
+    }
+    T Upper() const {
+        return Max;
+    }
+    T Width() const {
+        return Max - Min;
+    }
+
+    // Shrink the isolating interval to at most MaxWidth
+    void RefineTo(const T& MaxWidth) const {
+        if (IsExact() || Width() <= MaxWidth) return;
+
+        if (!P::RefineRoot(Expression, Min, Max, MaxWidth)) {
+            throw std::runtime_error("Isolating interval has no sign change");
+        }
+        if (Min == Max) SetExact(Min);
+    }
+
+    // -1, 0 or 1 as the value is below, equal to or above Other
+    // Disjoint intervals decide it. Otherwise the GCD of both polynomials settles equality once: a common root
+    // inside both intervals must be both values, and either way each polynomial can drop the factor its own
+    // value is not a root of. After that the intervals are halved until they separate
+    int32_t Compare(const PolyVal& Other) const {
+        if (IsExact() && Other.IsExact()) {
+            return Min < Other.Min ? -1 : (Other.Min < Min ? 1 : 0);
+        }
+
+        bool CheckedEqual = false;
+        while (true) {
+            if (Max < Other.Min || (Max == Other.Min && !Other.IsExact())) return -1;
+            if (Other.Max < Min || (Other.Max == Min && !IsExact())) return 1;
+
+            if (!CheckedEqual) {
+                CheckedEqual = true;
+
+                const P Common = P::GCD(Expression, Other.Expression);
+                if (Common.Degree() > 0) {
+                    const T Lower = std::max(Min, Other.Min);
+                    const T Upper = std::min(Max, Other.Max);
+                    const typename P::SturmEvaluator Evaluator(P::MakeSturmSequence(Common));
+
+                    if (CountRoots(Evaluator, Lower, Upper) > 0) {
+                        SetExpression(Common);
+                        Other.SetExpression(Common);
+                        return 0;
+                    }
+
+                    SetExpression(Expression / Common);
+                    Other.SetExpression(Other.Expression / Common);
+                }
+            }
+
+            RefineTo(Width() / 2);
+            Other.RefineTo(Other.Width() / 2);
+        }
+    }
+
+    PolyVal operator-() const {
+        if (IsExact()) return PolyVal(-Min);
+
+        // Root of P(-x)
+        std::vector<T> Cofs = Expression.ToDense();
+        for (size_t i = 1; i < Cofs.size(); i += 2) {
+            Cofs[i] = -Cofs[i];
+        }
+
+        PolyVal Res(P::FromDense(Cofs), -Max, -Min);
+        return Res;
+    }
+
+    PolyVal Inverse() const {
+        if (IsExact()) {
+            if (Min.IsZero()) throw std::runtime_error("Attempting reciprocal of zero");
+            return PolyVal(T(1) / Min);
+        }
 
-            Expression = P(T(1), Root) - P(Val, 0);
+        // Zero is the only root that could make the interval straddle the sign, and it isn't this one
+        while (!(Min > 0 || Max < 0)) {
+            if (Compare(PolyVal(T(0))) == 0) throw std::runtime_error("Attempting reciprocal of zero");
+            RefineTo(Width() / 2);
+            if (IsExact()) return Inverse();
         }
 
-        
+        // Root of x^n P(1 / x), the reversed coefficients
+        std::vector<T> Cofs = Expression.ToDense();
+        std::reverse(Cofs.begin(), Cofs.end());
+        while (!Cofs.empty() && Cofs.back().IsZero()) Cofs.pop_back();
+
+        return FromRoot(P::FromDense(Cofs), T(1) / Max, T(1) / Min);
+    }
+
+    PolyVal operator+(const PolyVal& Other) const {
+        if (IsExact() && Other.IsExact()) return PolyVal(Min + Other.Min);
+
+        // Adding a rational only shifts the polynomial
+        if (Other.IsExact()) {
+            return PolyVal(P::TaylorShift(Expression, -Other.Min), Min + Other.Min, Max + Other.Min);
+        }
+        if (IsExact()) return Other + *this;
+
+        // res_x(A(x), B(s - x)) vanishes at every sum of a root of A and a root of B
+        const Bivariate X = Bivariate::Variable(0);
+        const Bivariate S = Bivariate::Variable(1);
+        const P Resultant = Bivariate::Resultant(
+            Bivariate::FromUnivariate(Expression, 0), Bivariate::Substitute(Other.Expression, S - X), 0
+        );
+
+        return FromResultant(Other, Resultant, [](const PolyVal& L, const PolyVal& R) {
+            return std::make_pair(L.Min + R.Min, L.Max + R.Max);
+        });
+    }
+    PolyVal operator-(const PolyVal& Other) const {
+        return *this + -Other;
+    }
+
+    PolyVal operator*(const PolyVal& Other) const {
+        if (IsExact() && Other.IsExact()) return PolyVal(Min * Other.Min);
+
+        if (Other.IsExact()) {
+            const T Factor = Other.Min;
+            if (Factor.IsZero()) return PolyVal(T(0));
+
+            // Root of P(x / Factor)
+            std::vector<T> Cofs = Expression.ToDense();
+            T Scale = T(1);
+            for (T& Cof : Cofs) {
+                Cof = Cof / Scale;
+                Scale *= Factor;
+            }
+
+            const T A = Min * Factor;
+            const T B = Max * Factor;
+            return PolyVal(P::FromDense(Cofs), A < B ? A : B, A < B ? B : A);
+        }
+        if (IsExact()) return Other * *this;
+
+        // res_x(A(x), x^m B(s / x)) vanishes at every product of a root of A and a root of B, m = deg B
+        Bivariate Scaled;
+        const uint32_t Degree = Other.Expression.Degree();
+        for (const auto& t : Other.Expression.GetTerms()) {
+            Scaled += Bivariate(t.Cof, { Degree - t.Exp, t.Exp });
+        }
+        const P Resultant = Bivariate::Resultant(Bivariate::FromUnivariate(Expression, 0), Scaled, 0);
+
+        return FromResultant(Other, Resultant, [](const PolyVal& L, const PolyVal& R) {
+            const T Products[4] = { L.Min * R.Min, L.Min * R.Max, L.Max * R.Min, L.Max * R.Max };
+            return std::make_pair(*std::min_element(Products, Products + 4), *std::max_element(Products, Products + 4));
+        });
+    }
+    PolyVal operator/(const PolyVal& Other) const {
+        return *this * Other.Inverse();
+    }
+
+    PolyVal& operator+=(const PolyVal& Other) { return *this = *this + Other; }
+    PolyVal& operator-=(const PolyVal& Other) { return *this = *this - Other; }
+    PolyVal& operator*=(const PolyVal& Other) { return *this = *this * Other; }
+    PolyVal& operator/=(const PolyVal& Other) { return *this = *this / Other; }
+
+    bool operator==(const PolyVal& Other) const { return Compare(Other) == 0; }
+    bool operator!=(const PolyVal& Other) const { return Compare(Other) != 0; }
+    bool operator<(const PolyVal& Other) const { return Compare(Other) < 0; }
+    bool operator>(const PolyVal& Other) const { return Compare(Other) > 0; }
+    bool operator<=(const PolyVal& Other) const { return Compare(Other) <= 0; }
+    bool operator>=(const PolyVal& Other) const { return Compare(Other) >= 0; }
+
+    // Refines until the interval is narrower than the last printed digit
+    static std::string ToString(const PolyVal& Val, int64_t MaxDigits = 10) {
+        Val.RefineTo(T::Pow(T(10), -MaxDigits - 1));
+        return T::ToString((Val.Min + Val.Max) / 2, MaxDigits);
     }
-}
\ No newline at end of file
+};
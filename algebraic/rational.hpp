@@ -2,8 +2,8 @@
 
 #include "bignum.hpp"
 
-#include <map>
 #include <bit>
+#include <string_view>
 
 template<typename F>
 struct FloatTraits;
@@ -42,6 +42,39 @@ class Rational {
         }
     }
 
+    // Val must fit in 64 bits
+    static uint64_t SmallValue(const T& Val) {
+        uint64_t Res = 0;
+        for (size_t I = Val.Size(); I-- > 0;) {
+            Res = (Res << (sizeof(Val[0]) * 8)) | Val[I];
+        }
+        return Res;
+    }
+
+    // Smallest L in [1, Limit] with 10^L = 1 mod Mod, or 0 if there is none, for Mod > 1 coprime to 10
+    static uint64_t OrderOfTen(const T& Mod, uint64_t Limit) {
+        // R * 10 can't overflow below 2^60
+        if (Mod.TopBitIndex() < 60) {
+            const uint64_t M = SmallValue(Mod);
+            uint64_t R = 1;
+            for (uint64_t L = 1; L <= Limit; ++L) {
+                R = R * 10 % M;
+                if (R == 1) return L;
+            }
+            return 0;
+        }
+
+        const T One(1);
+        const T Ten(10);
+        T R = One;
+        for (uint64_t L = 1; L <= Limit; ++L) {
+            R *= Ten;
+            R.ApplyRemainder(Mod);
+            if (R == One) return L;
+        }
+        return 0;
+    }
+
 public:
     Rational() = default;
     Rational(int64_t Val) : A { Val } { }
@@ -71,6 +104,16 @@ public:
         normalize();
     }
 
+    // Skips the GCD, for values known to be in lowest terms already such as ones read back from a serialized form
+    // Den must be positive and share no factor with Num
+    static Rational FromReduced(T Num, T Den) {
+        if (Den.Sign() <= 0) throw std::runtime_error("Denominator must be positive");
+        Rational Res;
+        Res.A = std::move(Num);
+        Res.B = std::move(Den);
+        return Res;
+    }
+
     T Numerator() const {
         return A;
     }
@@ -78,6 +121,14 @@ public:
         return B;
     }
 
+    // Nearest double within a few ulps, huge or tiny values saturate to infinity or zero
+    double ToDouble() const {
+        int64_t ExpA, ExpB;
+        const double Num = A.ToDoubleScaled(ExpA);
+        const double Den = B.ToDoubleScaled(ExpB);
+        return std::ldexp(Num / Den, static_cast<int>(std::clamp<int64_t>(ExpA - ExpB, -(1 << 20), 1 << 20)));
+    }
+
     T Floor() const {
         return A / B - (A < 0 && A % B);
     }
@@ -125,34 +176,84 @@ public:
         return R;
     }
 
-    static std::string ToString(Rational Val, int64_t MaxDigits = 10) {
-        std::string Res = Val.A.Sign() < 0 ? "-" : "";
-        if (Val.A.Sign() < 0) Val.A = -Val.A;
-        T Quot = Val.A / Val.B;
-        T Rem = Val.A % Val.B;
-        Res += T::ToString(Quot);
-
-        if (Rem == T(0)) return Res;
-
-        Res += '.';
-        std::string Fraction;
-        std::map<T, size_t> RemPos;
-
-        while (Rem != T(0) && (MaxDigits-- > 0)) {
-            if (RemPos.count(Rem)) {
-                size_t RepeatStart = RemPos[Rem];
-                Fraction.insert(RepeatStart, "(");
-                Fraction += ")";
-                break;
+    // Streams the same text as ToString to Out, one std::string_view piece at a time
+    // The repeating part is located from the denominator alone: the digits before it number the larger of its
+    // powers of 2 and 5, and its length is the order of 10 modulo what is left, so no remainders are kept
+    // Digits come nine at a time from a single division each
+    template<typename Sink>
+    static void EmitDecimal(const Rational& Val, int64_t MaxDigits, Sink&& Out) {
+        if (Val.A.Sign() < 0) Out(std::string_view("-"));
+
+        T Rem = Val.A;
+        Rem.ApplyAbs();
+        T Quot;
+        Rem.ApplyRemainder(Val.B, &Quot);
+        Out(std::string_view(T::ToString(Quot)));
+
+        if (Rem.IsZero()) return;
+        Out(std::string_view("."));
+        if (MaxDigits <= 0) return;
+
+        // Sums skip the GCD, and the digits don't care, but the period has to come from the reduced denominator
+        const T G = T::GCD(Rem, Val.B);
+        Rem = T::DivideExact(Rem, G);
+        const T Den = T::DivideExact(Val.B, G);
+
+        T Coprime = Den;
+        const size_t Twos = Coprime.CountTrailingZeros();
+        Coprime >>= Twos;
+
+        size_t Fives = 0;
+        for (const T Five(5);;) {
+            T Next;
+            T Check = Coprime;
+            Check.ApplyRemainder(Five, &Next);
+            if (!Check.IsZero()) break;
+            Coprime = std::move(Next);
+            ++Fives;
+        }
+
+        const uint64_t Budget = static_cast<uint64_t>(MaxDigits);
+        const uint64_t Pre = std::max(Twos, Fives);
+
+        auto Digits = [&](uint64_t Count) {
+            static constexpr uint32_t Pow10[] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000 };
+            char Buffer[9];
+            while (Count > 0) {
+                const size_t Chunk = static_cast<size_t>(std::min<uint64_t>(Count, 9));
+                Rem *= T(Pow10[Chunk]);
+                T Block;
+                Rem.ApplyRemainder(Den, &Block);
+
+                uint64_t Value = SmallValue(Block);
+                for (size_t I = Chunk; I-- > 0; Value /= 10) Buffer[I] = char('0' + Value % 10);
+                Out(std::string_view(Buffer, Chunk));
+                Count -= Chunk;
             }
-            RemPos[Rem] = Fraction.size();
-            Rem = Rem * T(10);
-            T Digit = Rem / Val.B;
-            Fraction += char('0' + Digit[0]);
-            Rem = Rem % Val.B;
+        };
+
+        // Terminates after exactly Pre digits
+        if (Coprime == T(1)) {
+            Digits(std::min(Pre, Budget));
+            return;
+        }
+
+        // The cycle is only marked when it closes with room to spare, otherwise the digits just run out
+        const uint64_t Period = Pre + 1 < Budget ? OrderOfTen(Coprime, Budget - Pre - 1) : 0;
+        if (Period == 0) {
+            Digits(Budget);
+            return;
         }
 
-        Res += Fraction;
+        Digits(Pre);
+        Out(std::string_view("("));
+        Digits(Period);
+        Out(std::string_view(")"));
+    }
+
+    static std::string ToString(const Rational& Val, int64_t MaxDigits = 10) {
+        std::string Res;
+        EmitDecimal(Val, MaxDigits, [&](std::string_view Piece) { Res += Piece; });
         return Res;
     }
 
@@ -398,6 +398,27 @@ def main():
 
         return
     
+    # aft from the file written by "algebraic aft <n> <file>", one byte per cell holding the shortest residual's
+    # length rather than its value, rows are from and columns to
+    # 2nd param is the file, 3rd optionally the largest side to plot, every step-th row and column is shown
+    if sys.argv[1] == "aftf":
+        a = np.memmap(sys.argv[2], dtype=np.uint8, mode="r")
+        n = (a.size.bit_length() - 1) // 2
+        m = 2**n
+        if a.size != m * m:
+            raise ValueError(f"{a.size} bytes is not 4^n")
+        a = a.reshape((m, m))
+
+        side = int(sys.argv[3]) if len(sys.argv) > 3 else 1024
+        step = max(m // side, 1)
+        plt.imshow(a[::step, ::step])
+        plt.xlabel("to")
+        plt.ylabel("from")
+        plt.title(f"shortest residual lengths, n = {n}, every {step}th block")
+        plt.colorbar()
+        plt.show()
+        return
+
     # linear from to, shows how many residuals it takes to get to a single value from all possible values
     # 2nd param is the target values
     if sys.argv[1] == "lft":
@@ -0,0 +1,216 @@
+#pragma once
+
+#include "collatz.hpp"
+#include "workpool.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+// The residual algebra of res.py: the low N bits of a value as a Block, and what running Collatz on them hands up to
+// the bits above as a Residual
+namespace Cz {
+    // 3^Steps has to fit in a word for Residual::Val
+    constexpr size_t MaxResidualSteps = 40;
+
+    constexpr std::array<uint64_t, MaxResidualSteps + 1> Pow3Table = [] {
+        std::array<uint64_t, MaxResidualSteps + 1> Res {};
+        Res[0] = 1;
+        for (size_t i = 1; i < Res.size(); ++i) Res[i] = Res[i - 1] * 3;
+        return Res;
+    }();
+
+    // 1 / 3 modulo 2^Bits, Newton's iteration doubles the number of correct low bits per round
+    constexpr uint64_t Inverse3(size_t Bits) {
+        const uint64_t Mask = Bits >= 64 ? ~uint64_t(0) : (uint64_t(1) << Bits) - 1;
+        uint64_t Res = 1;
+        for (size_t Correct = 1; Correct < Bits; Correct *= 2) Res *= 2 - 3 * Res;
+        return Res & Mask;
+    }
+
+    // Steps multiplications by 3 and the carries that came up with them, as base 3 digits with the first carry on top
+    // A block B that receives it becomes B * 3^Steps + Val, so Val < 3^Steps
+    struct Residual {
+        size_t Steps = 0;
+        uint64_t Val = 0;
+
+        // This residual followed by Next
+        Residual Then(const Residual& Next) const {
+            if (Steps + Next.Steps > MaxResidualSteps) throw std::runtime_error("Residual longer than " + std::to_string(MaxResidualSteps) + " steps");
+            return { Steps + Next.Steps, Val * Pow3Table[Next.Steps] + Next.Val };
+        }
+
+        bool operator==(const Residual&) const = default;
+
+        static std::string ToString(const Residual& Res) {
+            return std::to_string(Res.Val) + "|" + std::to_string(Res.Steps);
+        }
+    };
+
+    template<size_t N>
+    struct Block {
+        static_assert(N >= 1 && N <= 32, "Blocks are 1 to 32 bits, so a block times 3^Steps fits in two words");
+
+        static constexpr uint64_t Mask = (uint64_t(1) << N) - 1;
+        // Every target is within this many steps of every start, since 3^ShortestLimit >= 2^N
+        static constexpr size_t ShortestLimit = [] {
+            size_t Res = 0;
+            while (Pow3Table[Res] < (uint64_t(1) << N)) ++Res;
+            return Res;
+        }();
+
+        uint64_t Val = 0;
+
+        bool operator==(const Block&) const = default;
+
+        // Collatz on the block alone, until its N bits are shifted out, with what each 3x + 1 carries past the top
+        Residual Run() const {
+            Residual Res;
+            uint64_t Cur = Val;
+            size_t Remaining = N;
+            while (Remaining > 0 && Cur != 0) {
+                if (Cur & 1) {
+                    Cur = 3 * Cur + 1;
+                    Res.Val = Res.Val * 3 + (Cur >> Remaining);
+                    Res.Steps += 1;
+                    Cur &= (uint64_t(1) << Remaining) - 1;
+                } else {
+                    const size_t Zeros = std::countr_zero(Cur);
+                    Cur >>= Zeros;
+                    Remaining -= Zeros;
+                }
+            }
+            return Res;
+        }
+
+        // The block after In arrives, and the residual it passes on in turn
+        // B * 3^k + r is split in 32-bit halves of 3^k, so no part of it overflows a word
+        std::pair<Residual, Block> Apply(const Residual& In) const {
+            if (In.Steps > MaxResidualSteps) throw std::runtime_error("Residual longer than " + std::to_string(MaxResidualSteps) + " steps");
+
+            const uint64_t Pow = Pow3Table[In.Steps];
+            const uint64_t Low = Val * (Pow & 0xFFFFFFFF) + (In.Val & 0xFFFFFFFF);
+            const uint64_t High = Val * (Pow >> 32) + (In.Val >> 32) + (Low >> 32);
+            const uint64_t Carry = (High << (32 - N)) | ((Low & 0xFFFFFFFF) >> N);
+            return { Residual { In.Steps, Carry }, Block { Low & Mask } };
+        }
+
+        // The block that In turns into After, the inverse of Apply: (After - r) / 3^k modulo 2^N
+        // res.py's compute_initial_block subtracts r after dividing, which only agrees for k = 0
+        static Block Before(const Residual& In, Block After) {
+            uint64_t Inverse = 1;
+            for (size_t i = 0; i < In.Steps; ++i) Inverse *= Inverse3(N);
+            return { ((After.Val - In.Val) * Inverse) & Mask };
+        }
+
+        // The shortest residual taking From to To, and of those the smallest: the first k with
+        // (To - From * 3^k) mod 2^N < 3^k, which is then the residual's value
+        static Residual Shortest(Block From, Block To) {
+            uint64_t Scaled = From.Val;
+            for (size_t Steps = 0;; ++Steps) {
+                const uint64_t Diff = (To.Val - Scaled) & Mask;
+                if (Diff < Pow3Table[Steps]) return { Steps, Diff };
+                Scaled = (3 * Scaled) & Mask;
+            }
+        }
+
+        // Shortest(From, To).Steps for the Count starts from First, into Out
+        // Counts the misses before the first hit over a fixed number of rounds, with the starts of a batch as the
+        // inner loop so it vectorizes, in 32-bit lanes: every 3^k below ShortestLimit is under 2^N, and for N = 32
+        // the wraparound is the reduction
+        static void ShortestSteps(uint64_t First, size_t Count, Block To, uint8_t* Out) {
+            static constexpr size_t Batch = 64;
+            const uint32_t Target = static_cast<uint32_t>(To.Val);
+            const uint32_t Low = static_cast<uint32_t>(Mask);
+
+            alignas(64) uint32_t Scaled[Batch];
+            alignas(64) uint32_t Missed[Batch];
+            alignas(64) uint32_t Steps[Batch];
+            for (size_t Done = 0; Done < Count; Done += Batch) {
+                const size_t Size = std::min(Batch, Count - Done);
+                for (size_t i = 0; i < Batch; ++i) {
+                    Scaled[i] = static_cast<uint32_t>(First + Done + i);
+                    Missed[i] = 1;
+                    Steps[i] = 0;
+                }
+                for (size_t k = 0; k < ShortestLimit; ++k) {
+                    const uint32_t Bound = static_cast<uint32_t>(Pow3Table[k]);
+                    for (size_t i = 0; i < Batch; ++i) {
+                        Missed[i] &= ((Target - Scaled[i]) & Low) >= Bound;
+                        Steps[i] += Missed[i];
+                        Scaled[i] *= 3;
+                    }
+                }
+                for (size_t i = 0; i < Size; ++i) Out[Done + i] = static_cast<uint8_t>(Steps[i]);
+            }
+        }
+
+        // How many of the 2^N starts have their shortest residual to To at each length, on Pool
+        static std::array<uint64_t, ShortestLimit + 1> ShortestHistogram(Block To, WorkPool& Pool) {
+            static constexpr uint64_t ChunkSize = uint64_t(1) << 16;
+            const uint64_t Chunks = (Mask >> 16) + 1;
+
+            std::mutex Lock;
+            std::array<uint64_t, ShortestLimit + 1> Res {};
+            Pool.ForEach(0, Pool.Size() * 4, [&](size_t Part) {
+                // Most starts share a handful of lengths, so one counter per lane of four keeps the increments from
+                // waiting on each other
+                std::array<std::array<uint64_t, ShortestLimit + 1>, 4> Counts {};
+                std::vector<uint8_t> Steps(ChunkSize);
+                for (uint64_t Chunk = Part; Chunk < Chunks; Chunk += Pool.Size() * 4) {
+                    const uint64_t First = Chunk * ChunkSize;
+                    const size_t Count = static_cast<size_t>(std::min(ChunkSize, Mask - First + 1));
+                    ShortestSteps(First, Count, To, Steps.data());
+                    for (size_t i = 0; i < Count; ++i) ++Counts[i % 4][Steps[i]];
+                }
+
+                std::lock_guard Guard(Lock);
+                for (const auto& Lane : Counts) {
+                    for (size_t i = 0; i < Lane.size(); ++i) Res[i] += Lane[i];
+                }
+            });
+            return Res;
+        }
+
+        // Shortest(From, To).Steps for every To, into Row[To]
+        // The targets exactly k steps away are the 3^k values from From * 3^k mod 2^N up, wrapping around, so the
+        // row is one filled interval per length, longest first so each target is left with its shortest
+        static void ShortestRow(Block From, uint8_t* Row) {
+            constexpr uint64_t Size = Mask + 1;
+
+            std::array<uint64_t, ShortestLimit> Scaled;
+            Scaled[0] = From.Val;
+            for (size_t k = 1; k < ShortestLimit; ++k) Scaled[k] = (3 * Scaled[k - 1]) & Mask;
+
+            std::fill(Row, Row + Size, static_cast<uint8_t>(ShortestLimit));
+            for (size_t k = ShortestLimit; k-- > 0;) {
+                const uint64_t First = Scaled[k];
+                const uint64_t Count = Pow3Table[k];
+                const uint64_t Head = std::min(Count, Size - First);
+                std::fill(Row + First, Row + First + Head, static_cast<uint8_t>(k));
+                std::fill(Row, Row + (Count - Head), static_cast<uint8_t>(k));
+            }
+        }
+
+        // res.py's aft matrix, the ShortestRow of every From at Out[From << N], split into bands of rows on Pool
+        static void ShortestMatrix(std::span<uint8_t> Out, WorkPool& Pool) {
+            constexpr uint64_t Size = Mask + 1;
+            if (Out.size() != Size * Size) throw std::runtime_error("Shortest residual matrix needs 4^N bytes");
+
+            Pool.ForEach(0, Size, [&](size_t From) { ShortestRow({ From }, Out.data() + (From << N)); });
+        }
+
+        static std::string ToString(Block Val) {
+            std::string Res(N, '0');
+            for (size_t i = 0; i < N; ++i) {
+                if ((Val.Val >> i) & 1) Res[N - 1 - i] = '1';
+            }
+            return Res + "|" + std::to_string(N);
+        }
+    };
+}
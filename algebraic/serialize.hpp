@@ -0,0 +1,393 @@
+#pragma once
+
+#include "polynomial.hpp"
+#include "complex.hpp"
+
+#include <bit>
+#include <cstring>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+// Lossless binary form of BigInt, Rational, Complex, Polynomial and Sturm sequences, unlike ToString which rounds
+// Nothing is aligned and every multi-byte value is little-endian, so a mapped file can be read in place
+//   Varint:     7 bits per byte, lowest first, the top bit set on every byte but the last
+//   BigInt:     varint (NumBytes << 1 | Negative), then the magnitude in NumBytes bytes lowest first, the top one nonzero
+//   Rational:   numerator then denominator, in lowest terms with the denominator positive
+//   Complex:    real part then imaginary part
+//   Polynomial: varint term count, then per term in increasing exponent order the varint gap from the previous
+//               exponent (the first from 0) and the coefficient
+//   Sturm:      varint count, then the polynomials
+//   Archive:    "ALGB", uint32 version, uint64 record count, the uint64 end offset of every record within the record
+//               area, then the records. Record i is found without walking the ones before it
+class WireWriter {
+    std::vector<uint8_t> Buffer;
+
+public:
+    const std::vector<uint8_t>& Bytes() const {
+        return Buffer;
+    }
+    size_t Size() const {
+        return Buffer.size();
+    }
+
+    void WriteVarint(uint64_t Val) {
+        while (Val >= 0x80) {
+            Buffer.push_back(static_cast<uint8_t>(Val) | 0x80);
+            Val >>= 7;
+        }
+        Buffer.push_back(static_cast<uint8_t>(Val));
+    }
+    void WriteFixed(uint64_t Val, size_t NumBytes) {
+        for (size_t i = 0; i < NumBytes; ++i) {
+            Buffer.push_back(static_cast<uint8_t>(Val >> (8 * i)));
+        }
+    }
+    void WriteBytes(std::span<const uint8_t> Bytes) {
+        Buffer.insert(Buffer.end(), Bytes.begin(), Bytes.end());
+    }
+
+    template<typename F, typename H>
+    void Write(const BigInt<F, H>& Val) {
+        size_t NumBytes = 0;
+        if (!Val.IsZero()) {
+            NumBytes = (Val.Size() - 1) * sizeof(H) + (std::bit_width(Val[Val.Size() - 1]) + 7) / 8;
+        }
+        WriteVarint(static_cast<uint64_t>(NumBytes) << 1 | (Val.Sign() < 0 ? 1 : 0));
+
+        const size_t Start = Buffer.size();
+        Buffer.resize(Start + NumBytes);
+        uint8_t* Out = Buffer.data() + Start;
+        for (size_t i = 0; i < Val.Size(); ++i) {
+            const H Word = Val[i];
+            const size_t Count = std::min(sizeof(H), NumBytes - i * sizeof(H));
+            if constexpr (std::endian::native == std::endian::little) {
+                std::memcpy(Out + i * sizeof(H), &Word, Count);
+            } else {
+                for (size_t b = 0; b < Count; ++b) Out[i * sizeof(H) + b] = static_cast<uint8_t>(Word >> (8 * b));
+            }
+        }
+    }
+    template<typename T>
+    void Write(const Rational<T>& Val) {
+        Write(Val.Numerator());
+        Write(Val.Denominator());
+    }
+    template<typename T>
+    void Write(const Complex<T>& Val) {
+        Write(Val.Real);
+        Write(Val.Imag);
+    }
+    template<typename T>
+    void Write(const Polynomial<T>& Val) {
+        const auto& Terms = Val.GetTerms();
+        WriteVarint(Terms.size());
+
+        uint32_t Prior = 0;
+        for (const auto& t : Terms) {
+            WriteVarint(t.Exp - Prior);
+            Prior = t.Exp;
+            Write(t.Cof);
+        }
+    }
+    // A Sturm sequence, or any list of polynomials
+    template<typename T>
+    void Write(const std::vector<Polynomial<T>>& Val) {
+        WriteVarint(Val.size());
+        for (const Polynomial<T>& Poly : Val) {
+            Write(Poly);
+        }
+    }
+};
+
+// Walks a buffer written by WireWriter, throws on anything truncated or malformed
+class WireReader {
+    const uint8_t* Pos = nullptr;
+    const uint8_t* End = nullptr;
+
+public:
+    WireReader() = default;
+    explicit WireReader(std::span<const uint8_t> Bytes) : Pos(Bytes.data()), End(Bytes.data() + Bytes.size()) {}
+
+    bool AtEnd() const {
+        return Pos == End;
+    }
+    const uint8_t* Position() const {
+        return Pos;
+    }
+
+    uint64_t ReadVarint() {
+        uint64_t Res = 0;
+        for (uint32_t Shift = 0; ; Shift += 7) {
+            if (Pos == End) throw std::runtime_error("Truncated varint");
+            if (Shift >= 64) throw std::runtime_error("Varint too long");
+
+            const uint8_t Byte = *Pos++;
+            Res |= static_cast<uint64_t>(Byte & 0x7F) << Shift;
+            if ((Byte & 0x80) == 0) return Res;
+        }
+    }
+    uint64_t ReadFixed(size_t NumBytes) {
+        const std::span<const uint8_t> Bytes = ReadBytes(NumBytes);
+        uint64_t Res = 0;
+        for (size_t i = 0; i < NumBytes; ++i) {
+            Res |= static_cast<uint64_t>(Bytes[i]) << (8 * i);
+        }
+        return Res;
+    }
+    std::span<const uint8_t> ReadBytes(size_t Count) {
+        if (static_cast<size_t>(End - Pos) < Count) throw std::runtime_error("Truncated record");
+        const std::span<const uint8_t> Res(Pos, Count);
+        Pos += Count;
+        return Res;
+    }
+};
+
+// The views below point into the buffer and copy nothing, Get builds the value when it is actually needed
+// The buffer must outlive them
+
+struct BigIntView {
+    bool Negative = false;
+    std::span<const uint8_t> Magnitude;
+
+    static BigIntView Read(WireReader& In) {
+        const uint64_t Header = In.ReadVarint();
+        BigIntView Res;
+        Res.Negative = (Header & 1) != 0;
+        Res.Magnitude = In.ReadBytes(Header >> 1);
+        if (!Res.Magnitude.empty() && Res.Magnitude.back() == 0) throw std::runtime_error("BigInt has a zero top byte");
+        if (Res.Magnitude.empty() && Res.Negative) throw std::runtime_error("Negative zero");
+        return Res;
+    }
+
+    int32_t Sign() const {
+        return Magnitude.empty() ? 0 : (Negative ? -1 : 1);
+    }
+
+    template<typename Integer = BigInt<>>
+    Integer Get() const {
+        using H = std::remove_cvref_t<decltype(std::declval<const Integer&>()[0])>;
+
+        std::vector<H> Words((Magnitude.size() + sizeof(H) - 1) / sizeof(H), 0);
+        if constexpr (std::endian::native == std::endian::little) {
+            if (!Magnitude.empty()) std::memcpy(Words.data(), Magnitude.data(), Magnitude.size());
+        } else {
+            for (size_t i = 0; i < Magnitude.size(); ++i) {
+                Words[i / sizeof(H)] |= static_cast<H>(Magnitude[i]) << (8 * (i % sizeof(H)));
+            }
+        }
+        return Integer::FromWords(std::move(Words), Negative);
+    }
+};
+
+struct RationalView {
+    BigIntView Num;
+    BigIntView Den;
+
+    static RationalView Read(WireReader& In) {
+        RationalView Res;
+        Res.Num = BigIntView::Read(In);
+        Res.Den = BigIntView::Read(In);
+        if (Res.Den.Sign() <= 0) throw std::runtime_error("Denominator must be positive");
+        return Res;
+    }
+
+    int32_t Sign() const {
+        return Num.Sign();
+    }
+
+    // Trusts the writer to have kept lowest terms, so no GCD is taken
+    template<typename R = Rational<>>
+    R Get() const {
+        using Integer = decltype(R().Numerator());
+        return R::FromReduced(Num.Get<Integer>(), Den.Get<Integer>());
+    }
+};
+
+template<typename Part = RationalView>
+struct ComplexView {
+    Part Real;
+    Part Imag;
+
+    static ComplexView Read(WireReader& In) {
+        ComplexView Res;
+        Res.Real = Part::Read(In);
+        Res.Imag = Part::Read(In);
+        return Res;
+    }
+
+    template<typename Z = Complex<>>
+    Z Get() const {
+        return Z(Real.template Get<decltype(Z().Real)>(), Imag.template Get<decltype(Z().Imag)>());
+    }
+};
+
+// Reading one walks its terms once to find where it ends, after that the terms are visited in place
+template<typename Cof = RationalView>
+class PolynomialView {
+    std::span<const uint8_t> Body;
+    size_t NumTerms = 0;
+    uint32_t Top = 0;
+
+public:
+    static PolynomialView Read(WireReader& In) {
+        PolynomialView Res;
+        Res.NumTerms = In.ReadVarint();
+
+        const uint8_t* Start = In.Position();
+        uint64_t Exp = 0;
+        for (size_t i = 0; i < Res.NumTerms; ++i) {
+            const uint64_t Gap = In.ReadVarint();
+            if (i > 0 && Gap == 0) throw std::runtime_error("Term exponents must increase");
+            Exp += Gap;
+            if (Exp > UINT32_MAX) throw std::runtime_error("Exponent out of range");
+            Cof::Read(In);
+        }
+        Res.Body = std::span<const uint8_t>(Start, In.Position());
+        Res.Top = static_cast<uint32_t>(Exp);
+        return Res;
+    }
+
+    size_t Size() const {
+        return NumTerms;
+    }
+    bool IsZero() const {
+        return NumTerms == 0;
+    }
+    uint32_t Degree() const {
+        return Top;
+    }
+
+    // Fn(uint32_t Exp, const Cof& Val) for every term, lowest exponent first
+    template<typename Fn>
+    void ForEachTerm(Fn&& Visit) const {
+        WireReader In(Body);
+        uint32_t Exp = 0;
+        for (size_t i = 0; i < NumTerms; ++i) {
+            Exp += static_cast<uint32_t>(In.ReadVarint());
+            const Cof Val = Cof::Read(In);
+            Visit(Exp, Val);
+        }
+    }
+
+    template<typename P = Polynomial<Rational<>>>
+    P Get() const {
+        using T = decltype(P().GetLeadingTerm().Cof);
+
+        std::vector<typename P::Term> Terms;
+        Terms.reserve(NumTerms);
+        ForEachTerm([&](uint32_t Exp, const Cof& Val) {
+            const T Converted = Val.template Get<T>();
+            if (Converted.IsZero()) throw std::runtime_error("Zero coefficient in term list");
+            Terms.push_back({ Exp, Converted });
+        });
+        return P::FromTerms(std::move(Terms));
+    }
+};
+
+template<typename Cof = RationalView>
+class SturmView {
+    std::vector<PolynomialView<Cof>> Polys;
+
+public:
+    static SturmView Read(WireReader& In) {
+        SturmView Res;
+        const uint64_t Count = In.ReadVarint();
+        for (uint64_t i = 0; i < Count; ++i) {
+            Res.Polys.push_back(PolynomialView<Cof>::Read(In));
+        }
+        return Res;
+    }
+
+    size_t Size() const {
+        return Polys.size();
+    }
+    const PolynomialView<Cof>& operator[](size_t Index) const {
+        return Polys[Index];
+    }
+
+    template<typename P = Polynomial<Rational<>>>
+    std::vector<P> Get() const {
+        std::vector<P> Res;
+        Res.reserve(Polys.size());
+        for (const PolynomialView<Cof>& Poly : Polys) {
+            Res.push_back(Poly.template Get<P>());
+        }
+        return Res;
+    }
+};
+
+// Collects records, each one anything WireWriter can write, and lays them out as an archive
+class ArchiveWriter {
+    WireWriter Records;
+    std::vector<uint64_t> Ends;
+
+public:
+    static constexpr uint32_t Version = 1;
+
+    template<typename V>
+    void Add(const V& Val) {
+        Records.Write(Val);
+        Ends.push_back(Records.Size());
+    }
+
+    std::vector<uint8_t> Finish() const {
+        WireWriter Res;
+        Res.WriteBytes(std::span<const uint8_t>(reinterpret_cast<const uint8_t*>("ALGB"), 4));
+        Res.WriteFixed(Version, 4);
+        Res.WriteFixed(Ends.size(), 8);
+        for (const uint64_t End : Ends) {
+            Res.WriteFixed(End, 8);
+        }
+        Res.WriteBytes(Records.Bytes());
+        return Res.Bytes();
+    }
+};
+
+// Random access to the records of an archive, checks the header and offsets but leaves the records alone
+class ArchiveView {
+    std::span<const uint8_t> Offsets;
+    std::span<const uint8_t> Body;
+
+    static uint64_t Load64(const uint8_t* Bytes) {
+        uint64_t Res = 0;
+        for (size_t i = 0; i < 8; ++i) {
+            Res |= static_cast<uint64_t>(Bytes[i]) << (8 * i);
+        }
+        return Res;
+    }
+    uint64_t EndOf(size_t Index) const {
+        return Load64(Offsets.data() + 8 * Index);
+    }
+
+public:
+    explicit ArchiveView(std::span<const uint8_t> Bytes) {
+        WireReader In(Bytes);
+        const std::span<const uint8_t> Magic = In.ReadBytes(4);
+        if (std::memcmp(Magic.data(), "ALGB", 4) != 0) throw std::runtime_error("Not an archive");
+        if (In.ReadFixed(4) != ArchiveWriter::Version) throw std::runtime_error("Unsupported archive version");
+
+        const uint64_t Count = In.ReadFixed(8);
+        if (Count > (Bytes.size() - 16) / 8) throw std::runtime_error("Truncated archive");
+        Offsets = In.ReadBytes(Count * 8);
+        Body = Bytes.subspan(16 + Count * 8);
+
+        uint64_t Prior = 0;
+        for (size_t i = 0; i < Count; ++i) {
+            const uint64_t End = EndOf(i);
+            if (End < Prior || End > Body.size()) throw std::runtime_error("Archive offsets out of order");
+            Prior = End;
+        }
+    }
+
+    size_t Size() const {
+        return Offsets.size() / 8;
+    }
+
+    // A reader over just that record
+    WireReader Record(size_t Index) const {
+        if (Index >= Size()) throw std::runtime_error("Archive record out of range");
+        const uint64_t Start = Index == 0 ? 0 : EndOf(Index - 1);
+        return WireReader(Body.subspan(Start, EndOf(Index) - Start));
+    }
+};
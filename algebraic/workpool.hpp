@@ -0,0 +1,210 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <exception>
+#include <memory>
+#include <algorithm>
+#include <stdint.h>
+
+// Work-stealing thread pool
+// Every worker owns a deque, it pushes and pops its own tasks at the back while idle workers steal from the front
+// Tasks submitted from threads outside the pool go to a shared queue that everyone steals from
+class WorkPool {
+public:
+    // A set of tasks that can be waited on independently of everything else in the pool
+    // Waiting is allowed from inside a task, the waiting thread keeps executing tasks until the group drains
+    class Group {
+        friend class WorkPool;
+
+        std::atomic<size_t> Pending { 0 };
+
+        std::mutex ErrorLock;
+        std::exception_ptr Error;
+
+    public:
+        Group() = default;
+        Group(const Group&) = delete;
+        Group& operator=(const Group&) = delete;
+        // Tasks still pending would finish against a dead group and whatever frame owned it, so that is fatal here
+        // rather than a use-after-free later
+        ~Group() {
+            if (Pending.load(std::memory_order_acquire) != 0) std::terminate();
+        }
+    };
+
+private:
+    struct Task {
+        std::function<void()> Fn;
+        Group* Owner = nullptr;
+    };
+
+    struct Queue {
+        std::mutex Lock;
+        std::deque<Task> Tasks;
+    };
+
+    // Index Workers.size() is the shared queue for outside submissions
+    std::vector<std::unique_ptr<Queue>> Queues;
+    std::vector<std::thread> Workers;
+
+    std::mutex SleepLock;
+    std::condition_variable Wake;
+    std::atomic<size_t> Queued { 0 };
+    bool Stopping = false;
+
+    struct ThreadSlot {
+        const WorkPool* Pool = nullptr;
+        size_t Index = 0;
+    };
+    static ThreadSlot& CurrentSlot() {
+        thread_local ThreadSlot Slot;
+        return Slot;
+    }
+
+    size_t HomeIndex() const {
+        const ThreadSlot& Slot = CurrentSlot();
+        return Slot.Pool == this ? Slot.Index : Workers.size();
+    }
+
+    bool TryPop(size_t Home, Task& Out) {
+        {
+            Queue& Own = *Queues[Home];
+            std::lock_guard Lock(Own.Lock);
+            if (!Own.Tasks.empty()) {
+                Out = std::move(Own.Tasks.back());
+                Own.Tasks.pop_back();
+                return true;
+            }
+        }
+
+        for (size_t i = 1; i < Queues.size(); ++i) {
+            Queue& Victim = *Queues[(Home + i) % Queues.size()];
+            std::lock_guard Lock(Victim.Lock);
+            if (!Victim.Tasks.empty()) {
+                Out = std::move(Victim.Tasks.front());
+                Victim.Tasks.pop_front();
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool TryRunOne(size_t Home) {
+        Task Current;
+        if (!TryPop(Home, Current)) return false;
+        Queued.fetch_sub(1);
+
+        try {
+            Current.Fn();
+        } catch (...) {
+            std::lock_guard Lock(Current.Owner->ErrorLock);
+            if (!Current.Owner->Error) Current.Owner->Error = std::current_exception();
+        }
+
+        // The group may be destroyed as soon as this hits zero, so it must be the last access
+        Current.Owner->Pending.fetch_sub(1, std::memory_order_release);
+        return true;
+    }
+
+    void WorkerLoop(size_t Index) {
+        CurrentSlot() = { this, Index };
+
+        while (true) {
+            if (TryRunOne(Index)) continue;
+
+            std::unique_lock Lock(SleepLock);
+            Wake.wait(Lock, [this] { return Stopping || Queued.load() > 0; });
+            if (Stopping && Queued.load() == 0) return;
+        }
+    }
+
+public:
+    explicit WorkPool(size_t NumThreads = std::thread::hardware_concurrency()) {
+        NumThreads = std::max<size_t>(NumThreads, 1);
+
+        for (size_t i = 0; i <= NumThreads; ++i) {
+            Queues.push_back(std::make_unique<Queue>());
+        }
+
+        Workers.reserve(NumThreads);
+        for (size_t i = 0; i < NumThreads; ++i) {
+            Workers.emplace_back([this, i] { WorkerLoop(i); });
+        }
+    }
+    WorkPool(const WorkPool&) = delete;
+    WorkPool& operator=(const WorkPool&) = delete;
+    ~WorkPool() {
+        {
+            std::lock_guard Lock(SleepLock);
+            Stopping = true;
+        }
+        Wake.notify_all();
+
+        for (std::thread& Worker : Workers) {
+            Worker.join();
+        }
+    }
+
+    size_t Size() const {
+        return Workers.size();
+    }
+
+    void Submit(Group& Owner, std::function<void()> Fn) {
+        Owner.Pending.fetch_add(1);
+
+        {
+            Queue& Target = *Queues[HomeIndex()];
+            std::lock_guard Lock(Target.Lock);
+            Target.Tasks.push_back({ std::move(Fn), &Owner });
+        }
+
+        Queued.fetch_add(1);
+        {
+            std::lock_guard Lock(SleepLock);
+        }
+        Wake.notify_one();
+    }
+
+    // Blocks until every task in the group has finished, executing pool tasks in the meantime
+    // Rethrows the first exception thrown by any task of the group
+    void Wait(Group& Owner) {
+        const size_t Home = HomeIndex();
+
+        while (Owner.Pending.load(std::memory_order_acquire) > 0) {
+            if (!TryRunOne(Home)) {
+                std::this_thread::yield();
+            }
+        }
+
+        std::exception_ptr Error;
+        {
+            std::lock_guard Lock(Owner.ErrorLock);
+            std::swap(Error, Owner.Error);
+        }
+        if (Error) std::rethrow_exception(Error);
+    }
+
+    // Run Fn(i) for every i in [Begin, End), splitting the range into roughly even pieces
+    void ForEach(size_t Begin, size_t End, const std::function<void(size_t)>& Fn) {
+        if (Begin >= End) return;
+
+        const size_t Pieces = std::min(End - Begin, Size() * 4);
+        const size_t Step = (End - Begin + Pieces - 1) / Pieces;
+
+        Group All;
+        for (size_t Start = Begin; Start < End; Start += Step) {
+            const size_t Stop = std::min(End, Start + Step);
+            Submit(All, [&Fn, Start, Stop] {
+                for (size_t i = Start; i < Stop; ++i) Fn(i);
+            });
+        }
+        Wait(All);
+    }
+};